@@ -0,0 +1,82 @@
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stddef.h>
+
+#include "util.h"
+
+/**
+ * @brief Allocator backend for the data buffers of matrices and vectors.
+ *
+ * The installed backend serves every buffer the library allocates separately
+ * from its header (data larger than INLINE_DATA_MAX_BYTES outside an arena).
+ * Headers and small inline data keep using aligned_alloc. Each object records
+ * the backend that allocated its data, so a buffer is always returned to its
+ * own backend even if another one was installed meanwhile.
+ *
+ * Both callbacks receive the same byte count for a given buffer: a multiple of
+ * ALIGNMENT, as get_aligned_size computes it.
+ */
+typedef struct alloc_backend_t {
+  /** @brief Short name for diagnostics. */
+  const char* name;
+  /** @brief Returns an ALIGNMENT-aligned block of 'bytes' bytes, or NULL. */
+  void* (*alloc)(void* ctx, size_t bytes);
+  /** @brief Releases a block returned by 'alloc' with the same 'bytes'. */
+  void (*free)(void* ctx, void* p, size_t bytes);
+  /** @brief Opaque pointer passed to both callbacks. */
+  void* ctx;
+} alloc_backend_t;
+
+/* ============================================================ */
+/*                       Built-in Backends                      */
+/* ============================================================ */
+
+/**
+ * @brief aligned_alloc/free. Installed by default; also releases buffers
+ * adopted through mat_wrap_rc and vec_wrap_rc.
+ */
+const alloc_backend_t* alloc_backend_default(void);
+
+/**
+ * @brief Anonymous mmap for buffers of at least ALLOC_HUGEPAGE_MIN bytes,
+ * aligned to that size and advised with MADV_HUGEPAGE so transparent huge
+ * pages can back them; smaller buffers fall back to aligned_alloc.
+ * @note Where mmap is unavailable large buffers come from aligned_alloc with
+ * huge-page alignment, without the advice.
+ */
+const alloc_backend_t* alloc_backend_hugepage(void);
+
+/**
+ * @brief Fresh anonymous pages, zeroed in parallel with the static OpenMP
+ * schedule of the element-wise kernels before they are handed out.
+ *
+ * Under the kernel's first-touch policy each page lands on the NUMA node of
+ * the thread that later processes it in mat_add_rc, vec_add_rc and friends,
+ * instead of all pages landing on the allocating thread's node. Reused pool
+ * buffers keep their placement. Works best with OMP_PROC_BIND set so threads
+ * stay on their node.
+ */
+const alloc_backend_t* alloc_backend_numa(void);
+
+/* ============================================================ */
+/*                       Backend Selection                      */
+/* ============================================================ */
+
+/**
+ * @brief Installs the backend for all subsequent data allocations.
+ * @param backend Pointer to the backend, or NULL for the default one. It must
+ * stay valid while any buffer it allocated is alive.
+ * @note The setting is process-wide and not synchronized: install a backend
+ * before other threads allocate matrices or vectors.
+ * @return ERR_OK on success, ERR_INVALID_ARG if a callback is missing, or an
+ * error code otherwise.
+ */
+util_error_t alloc_set_backend_rc(const alloc_backend_t* backend);
+
+/**
+ * @brief Returns the installed backend (never NULL).
+ */
+const alloc_backend_t* alloc_backend(void);
+
+#endif  // ALLOC_H
@@ -0,0 +1,100 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#include "util.h"
+
+/**
+ * @brief Opaque bump allocator for short-lived matrices and vectors.
+ *
+ * Memory is carved from large chunks by advancing a pointer, so an allocation
+ * costs a few instructions, and everything is released at once by
+ * arena_reset_rc. Chunks are kept across resets, so a steady workload stops
+ * calling malloc after the first round.
+ *
+ * While an arena is installed as the current arena of a thread (see
+ * arena_set_current), every matrix and vector the library creates on that
+ * thread (mat_alloc_rc, vec_alloc_rc and all functions built on them, such as
+ * the vec_*_new API) takes its header and data from it. Freeing such an
+ * object releases nothing from the arena; its memory returns to the arena on
+ * reset. Data that does not come from the arena is still owned by the object
+ * and leaks on reset unless the object is freed first: a buffer adopted with
+ * OWN_ADOPT, or a buffer obtained by resizing the object while no arena was
+ * installed.
+ *
+ * @note An arena is not thread-safe: install a separate arena per thread.
+ */
+typedef struct arena_t arena_t;
+
+/* ============================================================ */
+/*                      Lifecycle Management                    */
+/* ============================================================ */
+
+/**
+ * @brief Creates an arena.
+ * @param chunk_bytes Size of each chunk in bytes, or 0 for
+ * ARENA_DEFAULT_CHUNK. Requests larger than a chunk get a dedicated chunk.
+ * @param out Double pointer where the newly allocated arena will be stored.
+ * @return ERR_OK on success, or an error code otherwise. On error, *out is left
+ * unchanged.
+ */
+util_error_t arena_create_rc(size_t chunk_bytes, arena_t** out);
+
+/**
+ * @brief Releases an arena and all of its chunks.
+ * @param a Pointer to the arena (may be NULL). It must not be the current
+ * arena of any thread.
+ * @note Objects allocated from the arena become invalid.
+ */
+void arena_free_rc(arena_t* a);
+
+/**
+ * @brief Releases every allocation made from an arena at once. The chunks are
+ * kept for reuse.
+ * @param a Pointer to the arena.
+ * @note Objects allocated from the arena become invalid.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t arena_reset_rc(arena_t* a);
+
+/* ============================================================ */
+/*                          Allocation                          */
+/* ============================================================ */
+
+/**
+ * @brief Allocates a block of memory from an arena.
+ * @param a Pointer to the arena.
+ * @param bytes Size of the block in bytes.
+ * @return Pointer to an ALIGNMENT-aligned block, or NULL if a new chunk could
+ * not be allocated. The block must not be passed to free().
+ */
+void* arena_alloc(arena_t* a, size_t bytes);
+
+/**
+ * @brief Reports the number of bytes currently handed out by an arena.
+ * @param a Pointer to the arena.
+ * @param out Pointer where the result will be stored.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t arena_used_rc(const arena_t* a, size_t* out);
+
+/* ============================================================ */
+/*                        Current Arena                         */
+/* ============================================================ */
+
+/**
+ * @brief Installs an arena as the current arena of the calling thread.
+ * @param a Pointer to the arena, or NULL to return to heap allocation.
+ * @return The previously installed arena (or NULL), so that a call scope can
+ * restore it when it ends.
+ */
+arena_t* arena_set_current(arena_t* a);
+
+/**
+ * @brief Returns the current arena of the calling thread.
+ * @return Pointer to the arena, or NULL if none is installed.
+ */
+arena_t* arena_current(void);
+
+#endif  // ARENA_H
@@ -21,4 +21,64 @@
 // 32-byte alignment value
 #define ALIGNMENT 32
 
+// Cache line size (bytes). Blocks that hold a header and its data are aligned
+// to it, so a vector of up to 4 doubles shares one line with its header.
+#define CACHE_LINE_SIZE 64
+
+// Elements at which vector and matrix kernels split their loop across threads
+// (see parallel.h); smaller calls run on the calling thread, where the OpenMP
+// fork/join would cost more than the work. Element-wise kernels and reductions
+// have separate cutoffs, which can be recalibrated or loaded at runtime.
+#define PAR_STREAM_MIN 32768
+#define PAR_REDUCE_MIN 32768
+
+// Largest data block (bytes) allocated together with its vec_t/mat_t header.
+// Bigger buffers get an allocation of their own, which keeps swap and resize
+// O(1) for them; at that size the extra allocation is negligible anyway.
+#define INLINE_DATA_MAX_BYTES 65536UL
+
+// GEMM cache blocking (in doubles). A MC x KC block of A is packed to stay in
+// L2, a KC x NC panel of B is packed to stay in L3, and the micro-kernel
+// streams KC x NR slivers of B through L1. MC and NC must be multiples of the
+// micro-kernel tile sizes.
+#define GEMM_MC 96
+#define GEMM_KC 256
+#define GEMM_NC 4080
+
+// Tile size of the symmetric rank-k update. Lower-triangle tiles of this order
+// are the unit of parallel work.
+#define GEMM_SYRK_TILE 192
+
+// Products whose m, n and k are all at most this run on the calling thread
+// with no allocation and no parallel region: below it the fixed cost of the
+// blocked engine exceeds the arithmetic. Square row-major products of order
+// 2..7 use fixed-size kernels; everything else is packed into stack buffers
+// for the SIMD micro-kernel.
+#define GEMM_SMALL_MAX 32
+
+// Tile order of the blocked transposes. A tile of the source and its image in
+// the destination (2 x 8 KiB) stay in L1 while 4 x 4 blocks are moved.
+#define TRANSPOSE_TILE 32
+
+// Block size of the blocked matrix factorizations. Panels of this width are
+// factored with level-2 kernels; everything else is a GEMM update.
+#define DECOMP_BLOCK 64
+
+// Default chunk size of an arena (bytes). Requests that do not fit get a chunk
+// of their own.
+#define ARENA_DEFAULT_CHUNK (1UL << 20)
+
+// Buffers a thread's pool can hold at once (see pool.h), whatever its byte
+// cap.
+#define POOL_MAX_BUFFERS 32
+
+// Smallest buffer the huge-page allocator backend maps itself (see alloc.h),
+// and the alignment it gives such buffers: one x86-64 transparent huge page.
+#define ALLOC_HUGEPAGE_MIN (2UL << 20)
+
+// Extra columns sampled by the randomized SVD beyond the requested rank. The
+// additional directions make the captured range robust to a slowly decaying
+// spectrum.
+#define SVD_OVERSAMPLE 10
+
 #endif  // CONFIG_H
\ No newline at end of file
@@ -0,0 +1,254 @@
+#ifndef DECOMP_H
+#define DECOMP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "util.h"
+
+/* ============================================================ */
+/*                       LU Factorization                       */
+/* ============================================================ */
+
+/**
+ * @brief Computes the LU factorization with partial pivoting P * A = L * U
+ * of a square row-major matrix, in place.
+ *
+ * Right-looking blocked algorithm: each DECOMP_BLOCK-wide panel is factored
+ * with level-2 updates, then the trailing matrix is updated through the GEMM
+ * engine.
+ *
+ * @param a Pointer to the matrix (n x n, leading dimension lda). On return
+ * holds U on and above the diagonal and the unit lower factor L below it.
+ * @param n Order of the matrix.
+ * @param lda Leading dimension (row stride) of a.
+ * @param piv Array of n pivots: row i was interchanged with row piv[i].
+ * @param singular Set to true if an exactly zero pivot was encountered.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t decomp_lu_rc(double* a, size_t n, size_t lda, size_t* piv,
+                          bool* singular);
+
+/**
+ * @brief Applies the row interchanges recorded by decomp_lu_rc to the rows
+ * of a row-major block X (n x nrhs).
+ * @param n Number of rows of X.
+ * @param nrhs Number of columns of X.
+ * @param piv Pivot array produced by decomp_lu_rc.
+ * @param x Pointer to X.
+ * @param ldx Leading dimension of X.
+ */
+void decomp_lu_permute(size_t n, size_t nrhs, const size_t* piv, double* x,
+                       size_t ldx);
+
+/**
+ * @brief Solves L * U * x = P * b for a single right-hand side in place.
+ * @param n Order of the system.
+ * @param lu LU factors produced by decomp_lu_rc.
+ * @param lda Leading dimension of lu.
+ * @param piv Pivot array produced by decomp_lu_rc.
+ * @param x On entry the right-hand side b, on return the solution.
+ */
+void decomp_lu_solve_vec(size_t n, const double* lu, size_t lda,
+                         const size_t* piv, double* x);
+
+/* ============================================================ */
+/*                    Cholesky Factorization                    */
+/* ============================================================ */
+
+/**
+ * @brief Computes the Cholesky factorization A = L * L^T of a symmetric
+ * positive definite row-major matrix, in place.
+ *
+ * Right-looking blocked algorithm: each DECOMP_BLOCK diagonal block is
+ * factored unblocked, the panel below it is solved by a blocked TRSM and the
+ * trailing lower triangle is updated by a tiled SYRK.
+ *
+ * @param a Pointer to the matrix (n x n, leading dimension lda). Only the
+ * lower triangle is read; on return it holds L. The strict upper triangle is
+ * not accessed.
+ * @param n Order of the matrix.
+ * @param lda Leading dimension (row stride) of a.
+ * @return ERR_OK on success, ERR_NOT_POSDEF if a non-positive pivot was
+ * encountered, or an error code otherwise.
+ */
+util_error_t decomp_cholesky_rc(double* a, size_t n, size_t lda);
+
+/**
+ * @brief Solves L * L^T * x = b for a single right-hand side in place.
+ * @param n Order of the system.
+ * @param l Cholesky factor produced by decomp_cholesky_rc.
+ * @param lda Leading dimension of l.
+ * @param x On entry the right-hand side b, on return the solution.
+ */
+void decomp_cholesky_solve_vec(size_t n, const double* l, size_t lda,
+                               double* x);
+
+/* ============================================================ */
+/*                       QR Factorization                       */
+/* ============================================================ */
+
+/**
+ * @brief Computes the Householder QR factorization A = Q * R of a row-major
+ * m x n matrix, in place.
+ *
+ * Blocked compact-WY algorithm: each DECOMP_BLOCK-wide panel is factored with
+ * level-2 reflections, then the panel's reflectors are aggregated into
+ * I - V * T * V^T and applied to the trailing columns with two GEMMs.
+ *
+ * @param a Pointer to the matrix (m x n, leading dimension lda). On return
+ * holds R on and above the diagonal and the Householder vectors below it
+ * (their leading unit entries are implicit).
+ * @param m Number of rows.
+ * @param n Number of columns.
+ * @param lda Leading dimension (row stride) of a.
+ * @param tau Array of min(m, n) reflector scalars: H_j = I - tau[j] v_j v_j^T.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t decomp_qr_rc(double* a, size_t m, size_t n, size_t lda,
+                          double* tau);
+
+/**
+ * @brief Overwrites x (length m) with Q^T * x using the first k reflectors
+ * produced by decomp_qr_rc.
+ * @param m Number of rows of the factored matrix.
+ * @param k Number of reflectors.
+ * @param qr Factors produced by decomp_qr_rc.
+ * @param lda Leading dimension of qr.
+ * @param tau Reflector scalars produced by decomp_qr_rc.
+ * @param x Pointer to the vector.
+ */
+void decomp_qr_apply_qt_vec(size_t m, size_t k, const double* qr, size_t lda,
+                            const double* tau, double* x);
+
+/**
+ * @brief Solves the least-squares problem min ||A * x - b|| in place from the
+ * QR factors of a full-rank m x n matrix (m >= n).
+ * @param m Number of rows of A.
+ * @param n Number of columns of A.
+ * @param qr Factors produced by decomp_qr_rc.
+ * @param lda Leading dimension of qr.
+ * @param tau Reflector scalars produced by decomp_qr_rc.
+ * @param x On entry b (length m); on return x occupies the first n entries.
+ */
+void decomp_qr_solve_vec(size_t m, size_t n, const double* qr, size_t lda,
+                         const double* tau, double* x);
+
+/**
+ * @brief Overwrites C (m x ncols, row-major) with Q * C, where Q is the
+ * product of the first k reflectors produced by decomp_qr_rc. Blocked like
+ * the factorization.
+ * @param m Number of rows of the factored matrix and of C.
+ * @param k Number of reflectors.
+ * @param qr Factors produced by decomp_qr_rc.
+ * @param lda Leading dimension of qr.
+ * @param tau Reflector scalars produced by decomp_qr_rc.
+ * @param ncols Number of columns of C.
+ * @param c Pointer to C.
+ * @param ldc Leading dimension of C.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t decomp_qr_apply_q_rc(size_t m, size_t k, const double* qr,
+                                  size_t lda, const double* tau, size_t ncols,
+                                  double* c, size_t ldc);
+
+/**
+ * @brief Forms the first k columns of Q (m x k, row-major) from the first k
+ * reflectors produced by decomp_qr_rc. Blocked like the factorization.
+ * @param m Number of rows of the factored matrix.
+ * @param k Number of reflectors and columns of Q (k <= m).
+ * @param qr Factors produced by decomp_qr_rc.
+ * @param lda Leading dimension of qr.
+ * @param tau Reflector scalars produced by decomp_qr_rc.
+ * @param q Pointer to the output (m x k).
+ * @param ldq Leading dimension of q.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t decomp_qr_form_q_rc(size_t m, size_t k, const double* qr,
+                                 size_t lda, const double* tau, double* q,
+                                 size_t ldq);
+
+/* ============================================================ */
+/*                 Symmetric Tridiagonal Reduction              */
+/* ============================================================ */
+
+/**
+ * @brief Reduces a symmetric row-major matrix to tridiagonal form
+ * A = Q * T * Q^T with Householder reflections, in place.
+ *
+ * Blocked: the reflectors of each DECOMP_BLOCK-wide panel are accumulated
+ * together with their update vectors, and the trailing matrix receives the
+ * rank-2k update A -= V * W^T + W * V^T through the GEMM engine.
+ *
+ * @param a Pointer to the matrix (n x n, leading dimension lda). Only the
+ * lower triangle is read. On return the reflector v_j (whose leading unit
+ * entry sits in row j + 1) is stored in column j below the subdiagonal, so
+ * Q = H_0 * ... * H_{n-2} is the QR-style product of the reflectors stored in
+ * the (n - 1) x (n - 1) block at a + lda (see decomp_qr_apply_q_rc). The rest
+ * of the matrix is used as scratch.
+ * @param n Order of the matrix.
+ * @param lda Leading dimension (row stride) of a.
+ * @param d Array of n diagonal entries of T.
+ * @param e Array of n - 1 off-diagonal entries of T.
+ * @param tau Array of n - 1 reflector scalars.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t decomp_tridiag_rc(double* a, size_t n, size_t lda, double* d,
+                               double* e, double* tau);
+
+/* ============================================================ */
+/*                 Singular Value Decomposition                 */
+/* ============================================================ */
+
+/**
+ * @brief Computes the singular value decomposition G = U * S * V^T of a small
+ * row-major r x c matrix (r <= c) with one-sided Jacobi rotations.
+ *
+ * Pairs of rows are rotated until all rows are mutually orthogonal; the row
+ * norms are then the singular values. Accurate to working precision relative
+ * to each singular value, but O(r^2 * c) per sweep, so meant for the small
+ * projected problems of the randomized and iterative solvers.
+ *
+ * @param r Number of rows.
+ * @param c Number of columns (c >= r).
+ * @param g Pointer to G (leading dimension ldg). On return its rows hold the
+ * right singular vectors V^T, in the order of s (zero rows for zero singular
+ * values).
+ * @param ldg Leading dimension of g.
+ * @param s Array of r singular values, returned in descending order.
+ * @param u Pointer to the r x r output U (leading dimension ldu); the left
+ * singular vectors are its columns.
+ * @param ldu Leading dimension of u.
+ * @return ERR_OK on success, ERR_NO_CONVERGE if the rotations did not settle,
+ * or an error code otherwise.
+ */
+util_error_t decomp_svd_jacobi_rc(size_t r, size_t c, double* g, size_t ldg,
+                                  double* s, double* u, size_t ldu);
+
+/* ============================================================ */
+/*                      Triangular Solves                       */
+/* ============================================================ */
+
+/**
+ * @brief Overwrites X (n x nrhs, row-major) with T^{-1} * X, where T is the
+ * lower triangle of t. Element (i, j) of T is t[i * rst + j * cst], so the
+ * transpose of an upper triangle can be passed by swapping the strides.
+ * Blocked: off-diagonal updates go through the GEMM engine.
+ * @param unit If true, the diagonal of T is taken to be one and not read.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t decomp_trsm_lower_rc(size_t n, size_t nrhs, const double* t,
+                                  ptrdiff_t rst, ptrdiff_t cst, bool unit,
+                                  double* x, size_t ldx);
+
+/**
+ * @brief Overwrites X (n x nrhs, row-major) with T^{-1} * X, where T is the
+ * upper triangle of t, addressed as in decomp_trsm_lower_rc.
+ * @param unit If true, the diagonal of T is taken to be one and not read.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t decomp_trsm_upper_rc(size_t n, size_t nrhs, const double* t,
+                                  ptrdiff_t rst, ptrdiff_t cst, bool unit,
+                                  double* x, size_t ldx);
+
+#endif  // DECOMP_H
@@ -0,0 +1,75 @@
+#ifndef EIGEN_H
+#define EIGEN_H
+
+#include <stddef.h>
+
+#include "util.h"
+
+/* ============================================================ */
+/*                 Symmetric Tridiagonal Eigensolvers           */
+/* ============================================================ */
+
+/**
+ * @brief Computes all eigenvalues (and optionally eigenvectors) of a symmetric
+ * tridiagonal matrix with the implicit QL method.
+ * @param n Order of the matrix.
+ * @param d On entry the n diagonal entries; on return the eigenvalues in
+ * ascending order.
+ * @param e The n - 1 off-diagonal entries (not modified).
+ * @param z NULL for eigenvalues only. Otherwise a row-major n x n matrix
+ * (leading dimension ldz) holding an orthogonal basis on entry, usually the
+ * identity; on return it is multiplied by the eigenvectors, which are stored
+ * as columns in the order of d.
+ * @param ldz Leading dimension of z.
+ * @note O(n^2) without vectors and O(n^3) with them; used directly for
+ * eigenvalues only and for the leaves of the divide-and-conquer solver.
+ * @return ERR_OK on success, ERR_NO_CONVERGE if an eigenvalue did not
+ * converge, or an error code otherwise.
+ */
+util_error_t eigen_tridiag_ql_rc(size_t n, double* d, const double* e,
+                                 double* z, size_t ldz);
+
+/**
+ * @brief Computes all eigenpairs of a symmetric tridiagonal matrix with
+ * Cuppen's divide-and-conquer method.
+ *
+ * The matrix is torn into two halves by a rank-one modification, the halves
+ * are solved recursively and merged through the secular equation. Deflation
+ * removes negligible components, the eigenvectors of the rank-one problem
+ * use the Gu-Eisenstat correction so they stay orthogonal, and the merge is
+ * a GEMM against the eigenvectors of the halves.
+ *
+ * @param n Order of the matrix.
+ * @param d On entry the n diagonal entries; on return the eigenvalues in
+ * ascending order.
+ * @param e The n - 1 off-diagonal entries (not modified).
+ * @param z Pointer to a row-major n x n matrix (leading dimension ldz) that
+ * receives the eigenvectors as columns, in the order of d.
+ * @param ldz Leading dimension of z.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t eigen_tridiag_dc_rc(size_t n, double* d, const double* e,
+                                 double* z, size_t ldz);
+
+/**
+ * @brief Computes a contiguous range of eigenpairs of a symmetric tridiagonal
+ * matrix by bisection (Sturm sequence counts) and inverse iteration.
+ * @param n Order of the matrix.
+ * @param d The n diagonal entries (not modified).
+ * @param e The n - 1 off-diagonal entries (not modified).
+ * @param il Index (0-based, ascending order) of the first eigenvalue wanted.
+ * @param count Number of eigenvalues wanted (il + count <= n).
+ * @param w Array that receives the count eigenvalues in ascending order.
+ * @param z NULL for eigenvalues only, otherwise a row-major n x count matrix
+ * (leading dimension ldz) that receives the eigenvectors as columns.
+ * @param ldz Leading dimension of z.
+ * @note O(n * count) plus reorthogonalization inside clusters of close
+ * eigenvalues, so a few extreme eigenpairs cost far less than the full
+ * spectrum.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t eigen_tridiag_select_rc(size_t n, const double* d,
+                                     const double* e, size_t il, size_t count,
+                                     double* w, double* z, size_t ldz);
+
+#endif  // EIGEN_H
@@ -0,0 +1,224 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "mat_types.h"
+#include "util.h"
+
+/**
+ * @brief Computes C = alpha * A * B + beta * C on raw strided storage.
+ *
+ * Element (i, j) of an operand X is read from x[i * rsx + j * csx], so
+ * row-major, column-major and transposed operands are all expressed through
+ * the strides. The product is computed by the packed, cache-blocked engine:
+ * panels of A and B are copied into contiguous MC x KC / KC x NC buffers and a
+ * register-tiled micro-kernel accumulates MR x NR tiles of C.
+ *
+ * The packing buffers live in a workspace of the calling thread that is kept
+ * between calls and only grows, so repeated products of a given shape
+ * allocate nothing after the first one (see gemm_trim_rc).
+ *
+ * @param m Number of rows of A and C.
+ * @param n Number of columns of B and C.
+ * @param k Number of columns of A and rows of B.
+ * @param alpha Scalar multiplier of the product.
+ * @param a Pointer to the first element of A.
+ * @param rsa Row stride of A (in elements).
+ * @param csa Column stride of A (in elements).
+ * @param b Pointer to the first element of B.
+ * @param rsb Row stride of B (in elements).
+ * @param csb Column stride of B (in elements).
+ * @param beta Scalar multiplier of C. If zero, C is not read.
+ * @param c Pointer to the first element of C.
+ * @param rsc Row stride of C (in elements).
+ * @param csc Column stride of C (in elements).
+ * @note C must not overlap A or B.
+ * @return ERR_OK on success, or ERR_ALLOC if packing buffers can't be
+ * allocated.
+ */
+util_error_t gemm_strided_rc(size_t m, size_t n, size_t k, double alpha,
+                             const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                             const double* b, ptrdiff_t rsb, ptrdiff_t csb,
+                             double beta, double* c, ptrdiff_t rsc,
+                             ptrdiff_t csc);
+
+/**
+ * @brief gemm_strided_rc followed by a fused epilogue: biases and an
+ * activation applied to each tile of C as it is finalized.
+ * @param m Number of rows of A and C.
+ * @param n Number of columns of B and C.
+ * @param k Number of columns of A and rows of B.
+ * @param alpha Scalar multiplier of the product.
+ * @param a Pointer to the first element of A.
+ * @param rsa Row stride of A (in elements).
+ * @param csa Column stride of A (in elements).
+ * @param b Pointer to the first element of B.
+ * @param rsb Row stride of B (in elements).
+ * @param csb Column stride of B (in elements).
+ * @param beta Scalar multiplier of C. If zero, C is not read.
+ * @param c Pointer to the first element of C.
+ * @param rsc Row stride of C (in elements).
+ * @param csc Column stride of C (in elements).
+ * @param ep Pointer to the epilogue, or NULL for none.
+ * @return ERR_OK on success, ERR_INVALID_ARG or ERR_NULL for an inconsistent
+ * epilogue, or ERR_ALLOC if packing buffers can't be allocated.
+ */
+util_error_t gemm_strided_ep_rc(size_t m, size_t n, size_t k, double alpha,
+                                const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                                const double* b, ptrdiff_t rsb, ptrdiff_t csb,
+                                double beta, double* c, ptrdiff_t rsc,
+                                ptrdiff_t csc, const mat_epilogue_t* ep);
+
+/**
+ * @brief Computes C_t = alpha * A_t * B_t + beta * C_t for t = 0..count-1,
+ * where operand t of X starts at x + t * stride_x and every product has the
+ * same shape and strides.
+ *
+ * The batch is split across threads (each product on one thread) when that
+ * keeps every thread busy or the products are small (see
+ * gemm_batch_across); otherwise the products run one after another, each on
+ * all threads.
+ *
+ * @param count Number of products.
+ * @param m Number of rows of each A and C.
+ * @param n Number of columns of each B and C.
+ * @param k Number of columns of each A and rows of each B.
+ * @param alpha Scalar multiplier of the products.
+ * @param a Pointer to the first element of A_0.
+ * @param rsa Row stride of each A (in elements).
+ * @param csa Column stride of each A (in elements).
+ * @param stride_a Distance from A_t to A_(t+1) (in elements).
+ * @param b Pointer to the first element of B_0.
+ * @param rsb Row stride of each B (in elements).
+ * @param csb Column stride of each B (in elements).
+ * @param stride_b Distance from B_t to B_(t+1) (in elements).
+ * @param beta Scalar multiplier of each C. If zero, C is not read.
+ * @param c Pointer to the first element of C_0.
+ * @param rsc Row stride of each C (in elements).
+ * @param csc Column stride of each C (in elements).
+ * @param stride_c Distance from C_t to C_(t+1) (in elements).
+ * @note The C_t must not overlap each other or any A_t or B_t; the A_t and
+ * B_t may (e.g. stride_b = 0 multiplies every A_t by the same B).
+ * @return ERR_OK on success, or ERR_ALLOC if packing buffers can't be
+ * allocated.
+ */
+util_error_t gemm_strided_batched_rc(
+    size_t count, size_t m, size_t n, size_t k, double alpha, const double* a,
+    ptrdiff_t rsa, ptrdiff_t csa, ptrdiff_t stride_a, const double* b,
+    ptrdiff_t rsb, ptrdiff_t csb, ptrdiff_t stride_b, double beta, double* c,
+    ptrdiff_t rsc, ptrdiff_t csc, ptrdiff_t stride_c);
+
+/**
+ * @brief Tells whether a batch of 'count' products of the given (largest)
+ * shape is split across threads rather than run one product at a time.
+ * @param count Number of products.
+ * @param m Number of rows of A and C.
+ * @param n Number of columns of B and C.
+ * @param k Number of columns of A and rows of B.
+ * @return True if the batch is parallelized across its products.
+ */
+bool gemm_batch_across(size_t count, size_t m, size_t n, size_t k);
+
+/**
+ * @brief Opaque k x n right-hand operand packed once into the panel layout
+ * of the GEMM engine (see gemm_pack_rc).
+ */
+typedef struct gemm_packed_t gemm_packed_t;
+
+/**
+ * @brief Packs B for repeated products C = alpha * A * B + beta * C.
+ *
+ * Every product otherwise copies B into packed panels before computing; a
+ * packed operand lets many different A matrices be multiplied by the same B
+ * without that pass.
+ *
+ * @param k Number of rows of B.
+ * @param n Number of columns of B.
+ * @param b Pointer to the first element of B.
+ * @param rsb Row stride of B (in elements).
+ * @param csb Column stride of B (in elements).
+ * @param out Double pointer where the packed operand will be stored.
+ * @note The packed copy takes about as much memory as B (columns are padded
+ * to the micro-kernel width) and is independent of B afterwards.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t gemm_pack_rc(size_t k, size_t n, const double* b, ptrdiff_t rsb,
+                          ptrdiff_t csb, gemm_packed_t** out);
+
+/**
+ * @brief Releases a packed operand.
+ * @param bp Pointer to the packed operand (may be NULL).
+ */
+void gemm_packed_free_rc(gemm_packed_t* bp);
+
+/**
+ * @brief Computes C = alpha * A * B + beta * C with a pre-packed B, addressed
+ * as in gemm_strided_rc.
+ * @param m Number of rows of A and C.
+ * @param n Number of columns of B and C.
+ * @param k Number of columns of A and rows of B.
+ * @param alpha Scalar multiplier of the product.
+ * @param a Pointer to the first element of A.
+ * @param rsa Row stride of A (in elements).
+ * @param csa Column stride of A (in elements).
+ * @param b Pointer to the packed operand.
+ * @param beta Scalar multiplier of C. If zero, C is not read.
+ * @param c Pointer to the first element of C.
+ * @param rsc Row stride of C (in elements).
+ * @param csc Column stride of C (in elements).
+ * @return ERR_OK on success, ERR_DIM if 'b' was not packed from a k x n
+ * operand, or an error code otherwise.
+ */
+util_error_t gemm_packed_rc(size_t m, size_t n, size_t k, double alpha,
+                            const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                            const gemm_packed_t* b, double beta, double* c,
+                            ptrdiff_t rsc, ptrdiff_t csc);
+
+/**
+ * @brief Symmetric rank-k update of a lower triangle:
+ * C = alpha * A * A^T + beta * C, addressed as in gemm_strided_rc.
+ *
+ * The lower triangle of C is split into GEMM_SYRK_TILE square tiles that are
+ * updated in parallel, one GEMM per tile, so about half the flops of the full
+ * product are spent.
+ *
+ * @param n Order of C and number of rows of A.
+ * @param k Number of columns of A.
+ * @param alpha Scalar multiplier of the product.
+ * @param a Pointer to the first element of A (n x k).
+ * @param rsa Row stride of A (in elements).
+ * @param csa Column stride of A (in elements).
+ * @param beta Scalar multiplier of C. If zero, C is not read.
+ * @param c Pointer to the first element of C (n x n).
+ * @param rsc Row stride of C (in elements).
+ * @param csc Column stride of C (in elements).
+ * @note Only the lower triangle of C (diagonal included) is read or written.
+ * C must not overlap A.
+ * @return ERR_OK on success, or ERR_ALLOC if packing buffers can't be
+ * allocated.
+ */
+util_error_t gemm_syrk_lower_rc(size_t n, size_t k, double alpha,
+                                const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                                double beta, double* c, ptrdiff_t rsc,
+                                ptrdiff_t csc);
+
+/**
+ * @brief Frees the packing workspaces cached by the calling thread and by the
+ * worker threads of its OpenMP teams.
+ *
+ * The workspace of a thread is about (GEMM_MC * nthreads + GEMM_NC) * GEMM_KC
+ * doubles after a large product; the next product allocates it again. Worker
+ * threads hold one too once they have run SYRK tiles or batched products; they
+ * are trimmed through a team as large as the largest such team the calling
+ * thread opened, even if its thread count has been lowered since. A thread
+ * that never opened one starts no team. Threads that multiply matrices should
+ * call it before they exit.
+ *
+ * @note Called from inside a parallel region, it trims the calling thread
+ * only.
+ */
+void gemm_trim_rc(void);
+
+#endif  // GEMM_H
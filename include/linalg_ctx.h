@@ -0,0 +1,176 @@
+#ifndef LINALG_CTX_H
+#define LINALG_CTX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "parallel.h"
+#include "util.h"
+
+/**
+ * @brief Opaque execution context: thread budget, CPU pinning, parallel
+ * thresholds and scratch memory for the calls made under it.
+ *
+ * While a context is the current context of a thread (see
+ * linalg_ctx_set_current), every library call on that thread runs with its
+ * settings: parallel regions open at most its thread budget, kernels use its
+ * parallel thresholds where it sets them, and GEMM and matrix-vector
+ * workspaces come from its scratch buffer when they fit. A multi-threaded
+ * server can give each request a context of its own and so a bounded share of
+ * the cores, instead of every request fanning out over all of them.
+ *
+ * The _ctx variants of the products (mat_multiply_ctx_rc and friends) and
+ * LINALG_CTX_CALL install a context around a single call.
+ *
+ * @note A context holds the state it replaced on its thread, so it may be
+ * current on only one thread at a time. Worker threads started by a call do
+ * not see the context themselves; they inherit its effect through the team
+ * size and thresholds chosen by the calling thread.
+ */
+typedef struct linalg_ctx_t linalg_ctx_t;
+
+/**
+ * @brief CPU pinning policy of a context.
+ */
+typedef enum {
+  LINALG_PIN_NONE = 0,  ///< 0. Threads run wherever the OS schedules them.
+  LINALG_PIN_CORES = 1  ///< 1. Thread t of a team runs on CPU first + t % count.
+} linalg_pin_t;
+
+/* ============================================================ */
+/*                      Lifecycle Management                    */
+/* ============================================================ */
+
+/**
+ * @brief Creates a context that changes nothing yet: the OpenMP thread count
+ * of the calling thread, no pinning, the global thresholds, no scratch.
+ * @param out Double pointer where the newly allocated context will be stored.
+ * @return ERR_OK on success, or an error code otherwise. On error, *out is left
+ * unchanged.
+ */
+util_error_t linalg_ctx_create_rc(linalg_ctx_t** out);
+
+/**
+ * @brief Releases a context and its scratch buffer.
+ * @param ctx Pointer to the context (may be NULL). It must not be the current
+ * context of any thread.
+ */
+void linalg_ctx_free_rc(linalg_ctx_t* ctx);
+
+/* ============================================================ */
+/*                           Settings                           */
+/* ============================================================ */
+
+/**
+ * @brief Sets the thread budget of a context.
+ * @param ctx Pointer to the context.
+ * @param threads Maximum number of threads of a parallel region, or 0 to keep
+ * the thread count of the thread the context is installed on.
+ * @note Without OpenMP the budget is ignored.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t linalg_ctx_set_threads_rc(linalg_ctx_t* ctx, size_t threads);
+
+/**
+ * @brief Sets the CPU pinning policy of a context.
+ *
+ * With LINALG_PIN_CORES, installing the context pins the calling thread to
+ * CPU 'first' and the other threads of its OpenMP team to the following CPUs
+ * of the range. Giving concurrent contexts disjoint ranges keeps their
+ * requests off each other's cores.
+ *
+ * @param ctx Pointer to the context.
+ * @param pin Pinning policy.
+ * @param first First CPU of the range (ignored for LINALG_PIN_NONE).
+ * @param count Number of CPUs in the range (ignored for LINALG_PIN_NONE).
+ * @note The calling thread gets its previous affinity back when the context
+ * is uninstalled; the worker threads of its team stay pinned. Pinning is only
+ * applied on Linux and is silently skipped elsewhere.
+ * @return ERR_OK on success, ERR_INVALID_ARG for an unknown policy, ERR_RANGE
+ * for an empty or too large CPU range, or an error code otherwise.
+ */
+util_error_t linalg_ctx_set_pinning_rc(linalg_ctx_t* ctx, linalg_pin_t pin,
+                                       size_t first, size_t count);
+
+/**
+ * @brief Overrides one parallel threshold (see parallel.h) for the calls made
+ * under a context.
+ * @param ctx Pointer to the context.
+ * @param kind Kernel class.
+ * @param elements Elements at which its kernels go parallel; SIZE_MAX keeps
+ * them serial.
+ * @return ERR_OK on success, ERR_INVALID_ARG for an unknown class, or an error
+ * code otherwise.
+ */
+util_error_t linalg_ctx_set_threshold_rc(linalg_ctx_t* ctx, par_kernel_t kind,
+                                         size_t elements);
+
+/**
+ * @brief Allocates the scratch buffer of a context up front.
+ *
+ * GEMM packing buffers and the partial vectors of transposed matrix-vector
+ * products are taken from it instead of from per-thread caches or the heap,
+ * so a request served under the context does not allocate workspace. A
+ * workspace that does not fit falls back to the usual allocation.
+ *
+ * @param ctx Pointer to the context.
+ * @param bytes Size of the buffer; an existing smaller buffer is replaced.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t linalg_ctx_reserve_scratch_rc(linalg_ctx_t* ctx, size_t bytes);
+
+/* ============================================================ */
+/*                       Current Context                        */
+/* ============================================================ */
+
+/**
+ * @brief Installs a context as the current context of the calling thread.
+ *
+ * Uninstalls the previous context first, restoring the thread count and CPU
+ * affinity it replaced, then applies the settings of 'ctx'.
+ *
+ * @param ctx Pointer to the context, or NULL to return to the global settings.
+ * @return The previously installed context (or NULL), so that a call scope can
+ * restore it when it ends.
+ */
+linalg_ctx_t* linalg_ctx_set_current(linalg_ctx_t* ctx);
+
+/**
+ * @brief Returns the current context of the calling thread.
+ * @return Pointer to the context, or NULL if none is installed.
+ */
+linalg_ctx_t* linalg_ctx_current(void);
+
+/**
+ * @brief Stores in 'rc' the result of 'call', evaluated with 'ctx' as the
+ * current context: the context-taking form of any _rc function.
+ */
+#define LINALG_CTX_CALL(ctx, rc, call)                               \
+  do {                                                               \
+    linalg_ctx_t* linalg_ctx_prev_ = linalg_ctx_set_current(ctx);    \
+    (rc) = (call);                                                   \
+    linalg_ctx_set_current(linalg_ctx_prev_);                        \
+  } while (0)
+
+/* ============================================================ */
+/*                     Kernel Hooks (internal)                  */
+/* ============================================================ */
+
+/**
+ * @brief Looks up the threshold the current context sets for 'kind'.
+ * @param kind Kernel class.
+ * @param out Pointer where the threshold is stored if the context sets one.
+ * @return True if a context is current and overrides the threshold.
+ */
+bool linalg_ctx_threshold(par_kernel_t kind, size_t* out);
+
+/**
+ * @brief Returns the scratch buffer of the current context if it holds at
+ * least 'bytes' bytes.
+ * @return A CACHE_LINE_SIZE-aligned buffer, or NULL if no context is current
+ * or its scratch is smaller. The caller uses it only for the duration of one
+ * call and must not free it.
+ */
+void* linalg_ctx_scratch(size_t bytes);
+
+#endif  // LINALG_CTX_H
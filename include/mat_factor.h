@@ -0,0 +1,145 @@
+#ifndef MAT_FACTOR_H
+#define MAT_FACTOR_H
+
+#include "mat_types.h"
+#include "util.h"
+#include "vec_types.h"
+
+/**
+ * @brief Kind of factorization held by a mat_factor_t.
+ */
+typedef enum {
+  MAT_FACTOR_LU = 0,       ///< 0. P * A = L * U with partial pivoting.
+  MAT_FACTOR_CHOLESKY = 1  ///< 1. A = L * L^T for symmetric positive definite A.
+} mat_factor_kind_t;
+
+/**
+ * @brief Opaque handle to a factorization of a square matrix.
+ *
+ * The factorization is computed once (O(n^3)); every solve afterwards only
+ * runs triangular solves (O(n^2) per right-hand side). The handle is
+ * independent of the source matrix, which may be modified or freed. Solves
+ * do not modify the handle, so it can be shared between threads. It never
+ * takes memory from the current arena (see arena.h), so it survives resets.
+ */
+typedef struct mat_factor_t mat_factor_t;
+
+/* ============================================================ */
+/*                      Lifecycle Management                    */
+/* ============================================================ */
+
+/**
+ * @brief Computes the LU factorization with partial pivoting of a matrix.
+ * @param a Pointer to the square matrix to factor.
+ * @param out Double pointer where the newly allocated handle will be stored.
+ * @note A singular matrix still produces a handle (its determinant is zero),
+ * but solves against it fail with ERR_DIV_ZERO.
+ * @return ERR_OK on success, or an error code otherwise. On error, *out is left
+ * unchanged.
+ */
+util_error_t mat_factor_lu_rc(const mat_t* restrict a,
+                              mat_factor_t** restrict out);
+
+/**
+ * @brief Computes the Cholesky factorization of a symmetric positive definite
+ * matrix. Only the lower triangle of the matrix is read.
+ * @param a Pointer to the square matrix to factor.
+ * @param out Double pointer where the newly allocated handle will be stored.
+ * @return ERR_OK on success, ERR_NOT_POSDEF if the matrix is not positive
+ * definite, or an error code otherwise. On error, *out is left unchanged.
+ */
+util_error_t mat_factor_cholesky_rc(const mat_t* restrict a,
+                                    mat_factor_t** restrict out);
+
+/**
+ * @brief Deallocates a factorization handle.
+ * @param f Pointer to the handle to be freed.
+ */
+void mat_factor_free_rc(mat_factor_t* f);
+
+/* ============================================================ */
+/*                          Inspection                          */
+/* ============================================================ */
+
+/**
+ * @brief Retrieves the kind of factorization held by the handle.
+ * @param f Pointer to the handle.
+ * @param out Pointer where the kind will be stored.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_factor_kind_rc(const mat_factor_t* restrict f,
+                                mat_factor_kind_t* restrict out);
+
+/**
+ * @brief Retrieves the order of the factored matrix.
+ * @param f Pointer to the handle.
+ * @param out Pointer where the order will be stored.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_factor_size_rc(const mat_factor_t* restrict f,
+                                size_t* restrict out);
+
+/**
+ * @brief Computes the determinant of the factored matrix in O(n).
+ * @param f Pointer to the handle.
+ * @param out Pointer to a double where the determinant will be stored.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_factor_det_rc(const mat_factor_t* restrict f,
+                               double* restrict out);
+
+/**
+ * @brief Computes sign and log|det| of the factored matrix in O(n), so that
+ * det = sign * exp(out) without overflow.
+ * @param f Pointer to the handle.
+ * @param sign Pointer to a double where the sign (-1, 0 or 1) will be stored.
+ * @param out Pointer to a double where log|det| will be stored (-INFINITY if
+ * the matrix is singular).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_factor_logdet_rc(const mat_factor_t* restrict f,
+                                  double* restrict sign, double* restrict out);
+
+/* ============================================================ */
+/*                            Solves                            */
+/* ============================================================ */
+
+/**
+ * @brief Solves A * x = b using a precomputed factorization.
+ * @param f Pointer to the factorization of A.
+ * @param b Pointer to the right-hand side vector.
+ * @param out Pointer to the vector where the solution will be stored.
+ * @note Arguments 'f', 'b', and 'out' must not overlap (restrict pointers).
+ * @return ERR_OK on success, ERR_DIV_ZERO if A is singular, or an error code
+ * otherwise.
+ */
+util_error_t mat_factor_solve_vec_rc(const mat_factor_t* restrict f,
+                                     const vec_t* restrict b,
+                                     vec_t* restrict out);
+
+/**
+ * @brief Solves A * X = B for a block of right-hand sides (the columns of B)
+ * using a precomputed factorization. The triangular solves are blocked and
+ * run through the GEMM engine.
+ * @param f Pointer to the factorization of A.
+ * @param b Pointer to the right-hand side matrix (n x k).
+ * @param out Pointer to the matrix where the solution will be stored (n x k).
+ * @note Arguments 'f', 'b', and 'out' must not overlap (restrict pointers).
+ * @return ERR_OK on success, ERR_DIV_ZERO if A is singular, or an error code
+ * otherwise.
+ */
+util_error_t mat_factor_solve_mat_rc(const mat_factor_t* restrict f,
+                                     const mat_t* restrict b,
+                                     mat_t* restrict out);
+
+/**
+ * @brief Computes the inverse of the factored matrix.
+ * @param f Pointer to the factorization of A.
+ * @param out Pointer to the matrix where A^{-1} will be stored (n x n).
+ * @return ERR_OK on success, ERR_DIV_ZERO if A is singular, or an error code
+ * otherwise.
+ */
+util_error_t mat_factor_inverse_rc(const mat_factor_t* restrict f,
+                                   mat_t* restrict out);
+
+#endif  // MAT_FACTOR_H
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 
+#include "linalg_ctx.h"
 #include "mat_types.h"
 #include "util.h"
 #include "vec_types.h"
@@ -16,6 +17,9 @@
  * @param out Double pointer where the newly allocated matrix will be stored.
  * @param rows Number of rows to allocate.
  * @param cols Number of columns to allocate.
+ * @note Header and data are allocated as one cache-line-aligned block unless
+ * the data exceeds INLINE_DATA_MAX_BYTES. If the calling thread has a current
+ * arena (see arena.h), the matrix is taken from it.
  * @return ERR_OK on success, or an error code otherwise. On error, *out is left
  * unchanged.
  */
@@ -34,9 +38,32 @@ util_error_t mat_alloc_rc(mat_t** restrict out, size_t rows, size_t cols);
 util_error_t mat_from_array_rc(const double* restrict data,
                                mat_t** restrict out, size_t rows, size_t cols);
 
+/**
+ * @brief Creates a matrix over a caller-provided buffer (row-major order)
+ * without copying it.
+ * @param data Pointer to rows * cols doubles.
+ * @param out Double pointer where the newly allocated matrix will be stored.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param own OWN_BORROW to leave the buffer with the caller, who must keep it
+ * alive until the matrix is freed; OWN_ADOPT to hand it over, in which case it
+ * must come from malloc/aligned_alloc and is released by mat_free_rc.
+ * @note The buffer is used in place when it is ALIGNMENT-aligned. Otherwise it
+ * is copied into an owned aligned buffer (and, for OWN_ADOPT, freed); the
+ * 'owns_data' field of the result tells which happened.
+ * @note mat_resize_rc always moves the data into a new buffer and leaves a
+ * borrowed one untouched.
+ * @return ERR_OK on success, or an error code otherwise. On error, *out is left
+ * unchanged and an adopted buffer still belongs to the caller.
+ */
+util_error_t mat_wrap_rc(double* data, mat_t** restrict out, size_t rows,
+                         size_t cols, util_ownership_t own);
+
 /**
  * @brief Deallocates the memory occupied by the matrix.
  * @param m Pointer to the matrix to be freed.
+ * @note A borrowed buffer (see mat_wrap_rc) is left to its owner, and memory
+ * taken from an arena (see arena.h) is left to the arena.
  */
 void mat_free_rc(mat_t* m);
 
@@ -111,6 +138,7 @@ util_error_t mat_get_rc(const mat_t* restrict m, size_t i, size_t j,
  * @param row Index of the row to retrieve.
  * @param out Pointer to the destination vector.
  * @note Arguments 'm' and 'out' must not overlap (restrict pointers).
+ * @note Copies the row; mat_view_row_rc (mat_view.h) addresses it in place.
  * @return ERR_OK on success, or an error code otherwise.
  */
 util_error_t mat_get_row(const mat_t* restrict m, size_t row,
@@ -122,6 +150,8 @@ util_error_t mat_get_row(const mat_t* restrict m, size_t row,
  * @param col Index of the column to retrieve.
  * @param out Pointer to the destination vector.
  * @note Arguments 'm' and 'out' must not overlap (restrict pointers).
+ * @note Gathers the column; mat_view_col_rc (mat_view.h) addresses it in place
+ * through the row stride.
  * @return ERR_OK on success, or an error code otherwise.
  */
 util_error_t mat_get_column(const mat_t* restrict m, size_t col,
@@ -286,6 +316,134 @@ util_error_t mat_map_rc(const mat_t* restrict src, mat_t* restrict dest,
 util_error_t mat_multiply_rc(const mat_t* restrict a, const mat_t* restrict b,
                              mat_t* restrict out);
 
+/**
+ * @brief General matrix product C = alpha * op(A) * op(B) + beta * C, where
+ * op(X) is X or X^T.
+ *
+ * Transposed operands are read in place through swapped strides and the
+ * scaling and accumulation happen while C is written, so the whole update is
+ * one pass of the GEMM engine with no temporary matrices.
+ *
+ * @param trans_a Whether A enters the product transposed.
+ * @param trans_b Whether B enters the product transposed.
+ * @param alpha Scalar multiplier of the product.
+ * @param a Pointer to the matrix A.
+ * @param b Pointer to the matrix B.
+ * @param beta Scalar multiplier of C. If zero, C is not read (it may hold
+ * garbage, NaN included).
+ * @param c Pointer to the matrix C (updated in place); it must be
+ * rows(op(A)) x cols(op(B)).
+ * @note C must not overlap A or B (restrict pointers); A and B may be the same
+ * matrix, e.g. for A^T * A.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_gemm_rc(util_transpose_t trans_a, util_transpose_t trans_b,
+                         double alpha, const mat_t* a, const mat_t* b,
+                         double beta, mat_t* restrict c);
+
+/**
+ * @brief mat_gemm_rc with a fused epilogue: per-row/per-column biases and an
+ * activation (ReLU, clamp, tanh, sigmoid or a callback) applied to each tile
+ * of C while it is still in cache.
+ *
+ * Replaces a product followed by bias additions and mat_map_rc, each of which
+ * would be another full pass over C.
+ *
+ * @param trans_a Whether A enters the product transposed.
+ * @param trans_b Whether B enters the product transposed.
+ * @param alpha Scalar multiplier of the product.
+ * @param a Pointer to the matrix A.
+ * @param b Pointer to the matrix B.
+ * @param beta Scalar multiplier of C. If zero, C is not read.
+ * @param c Pointer to the matrix C (updated in place).
+ * @param ep Pointer to the epilogue (see mat_epilogue_t), or NULL for none.
+ * Its bias arrays must hold c->cols (col_bias) and c->rows (row_bias) values.
+ * @note C must not overlap A, B or the bias arrays.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_gemm_ep_rc(util_transpose_t trans_a, util_transpose_t trans_b,
+                            double alpha, const mat_t* a, const mat_t* b,
+                            double beta, mat_t* restrict c,
+                            const mat_epilogue_t* ep);
+
+/**
+ * @brief Packs a matrix for use as the right-hand operand of many products.
+ *
+ * mat_multiply_rc copies B into the GEMM engine's panel layout on every call.
+ * When many matrices are multiplied by the same B (e.g. a weight matrix),
+ * packing it once and calling mat_multiply_packed_rc skips that pass.
+ *
+ * @param b Pointer to the matrix to pack.
+ * @param out Double pointer where the packed operand will be stored.
+ * @note The packed copy does not refer to 'b'; it must be packed again after
+ * 'b' changes.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_pack_rc(const mat_t* restrict b, mat_packed_t** restrict out);
+
+/**
+ * @brief Releases a packed operand.
+ * @param p Pointer to the packed operand (may be NULL).
+ */
+void mat_packed_free_rc(mat_packed_t* p);
+
+/**
+ * @brief Computes the matrix product of a matrix and a packed operand.
+ * @param a Pointer to the first matrix.
+ * @param b Pointer to the packed second matrix (see mat_pack_rc).
+ * @param out Pointer to the matrix where the product will be stored.
+ * @note Arguments 'a' and 'out' must not overlap (restrict pointers).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_multiply_packed_rc(const mat_t* restrict a,
+                                    const mat_packed_t* restrict b,
+                                    mat_t* restrict out);
+
+/**
+ * @brief Computes out[t] = a[t] * b[t] for a batch of independent products.
+ *
+ * Many small products are spread over the threads, one product per thread at
+ * a time, instead of each product opening a parallel region of its own.
+ * Batches of a few large products run one after another, each using all
+ * threads. Shapes may differ between products.
+ *
+ * @param a Array of 'count' pointers to the left matrices.
+ * @param b Array of 'count' pointers to the right matrices.
+ * @param out Array of 'count' pointers to the result matrices.
+ * @param count Number of products.
+ * @note Every operand is validated before any product is computed. The
+ * results must not overlap each other or any operand.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_multiply_batched_rc(const mat_t* const* a,
+                                     const mat_t* const* b,
+                                     mat_t* const* out, size_t count);
+
+/**
+ * @brief Computes count products of equally shaped matrices stored back to
+ * back: out_t = a_t * b_t, with a_t the m x k row-major matrix at
+ * a + t * m * k, b_t the k x n matrix at b + t * k * n and out_t the m x n
+ * matrix at out + t * m * n.
+ *
+ * Parallelized across the batch like mat_multiply_batched_rc. The buffers are
+ * raw arrays so a batch is not limited by MATRIX_MAX_ROWS.
+ *
+ * @param count Number of products.
+ * @param m Number of rows of each left matrix.
+ * @param k Number of columns of each left matrix.
+ * @param n Number of columns of each right matrix.
+ * @param a Pointer to count * m * k values.
+ * @param b Pointer to count * k * n values.
+ * @param out Pointer to count * m * n values.
+ * @note 'out' must not overlap 'a' or 'b' (restrict pointers).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_multiply_strided_batched_rc(size_t count, size_t m, size_t k,
+                                             size_t n,
+                                             const double* restrict a,
+                                             const double* restrict b,
+                                             double* restrict out);
+
 /**
  * @brief Computes the product of a matrix and a vector.
  * @param m Pointer to the matrix.
@@ -297,6 +455,79 @@ util_error_t mat_multiply_rc(const mat_t* restrict a, const mat_t* restrict b,
 util_error_t mat_vec_multiply_rc(const mat_t* restrict m,
                                  const vec_t* restrict v, vec_t* restrict out);
 
+/**
+ * @brief Computes out[r] = m * v[r] for k vectors in a single pass over m.
+ *
+ * Each row of m is read from memory once and multiplied with four vectors at
+ * a time while it sits in cache, so the memory traffic is that of one
+ * matrix-vector product rather than k. The vectors themselves should fit in
+ * cache together (k * cols doubles) to get the full benefit. Right-hand sides
+ * stored as the columns of a cols x k matrix need no gathering: mat_multiply_rc
+ * also reads m only once for them.
+ *
+ * @param m Pointer to the matrix.
+ * @param v Array of 'k' pointers to vectors of m->cols elements.
+ * @param out Array of 'k' pointers to vectors of m->rows elements.
+ * @param k Number of vectors.
+ * @note Every operand is validated before any product is computed. The
+ * results must not overlap each other or any operand.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_vec_multiply_multi_rc(const mat_t* restrict m,
+                                       const vec_t* const* v,
+                                       vec_t* const* out, size_t k);
+
+/**
+ * @brief Computes y = alpha * op(A) * x + beta * y.
+ *
+ * op(A) is A or its transpose. The transposed product does not form A^T: rows
+ * of A are streamed and accumulated axpy-style, each thread into a partial
+ * vector of its own that is summed into y at the end.
+ *
+ * @param trans TRANS_NONE for op(A) = A, TRANS_T for op(A) = A^T.
+ * @param alpha Scalar applied to op(A) * x.
+ * @param a Pointer to the matrix A.
+ * @param x Pointer to the vector x; its length is the column count of op(A).
+ * @param beta Scalar applied to y on input. If it is 0, y is not read.
+ * @param y Pointer to the vector y; its length is the row count of op(A).
+ * @note Arguments 'a', 'x', and 'y' must not overlap (restrict pointers).
+ * @return ERR_OK on success, ERR_INVALID_ARG for an unknown 'trans', or an
+ * error code otherwise.
+ */
+util_error_t mat_gemv_rc(util_transpose_t trans, double alpha,
+                         const mat_t* restrict a, const vec_t* restrict x,
+                         double beta, vec_t* restrict y);
+
+/**
+ * @brief mat_multiply_rc run under an execution context (see linalg_ctx.h):
+ * its thread budget, pinning, thresholds and scratch apply to this call only.
+ * @param ctx Pointer to the context. It must not be current on another thread.
+ * @note Any other _rc function can be run under a context with LINALG_CTX_CALL.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_multiply_ctx_rc(linalg_ctx_t* ctx, const mat_t* restrict a,
+                                 const mat_t* restrict b, mat_t* restrict out);
+
+/**
+ * @brief mat_gemm_rc run under an execution context (see
+ * mat_multiply_ctx_rc).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_gemm_ctx_rc(linalg_ctx_t* ctx, util_transpose_t trans_a,
+                             util_transpose_t trans_b, double alpha,
+                             const mat_t* a, const mat_t* b, double beta,
+                             mat_t* restrict c);
+
+/**
+ * @brief mat_gemv_rc run under an execution context (see
+ * mat_multiply_ctx_rc).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_gemv_ctx_rc(linalg_ctx_t* ctx, util_transpose_t trans,
+                             double alpha, const mat_t* restrict a,
+                             const vec_t* restrict x, double beta,
+                             vec_t* restrict y);
+
 /* ============================================================ */
 /*                    Matrix Transformations                    */
 /* ============================================================ */
@@ -305,11 +536,27 @@ util_error_t mat_vec_multiply_rc(const mat_t* restrict m,
  * @brief Performs matrix transposition.
  * @param a Pointer to the source matrix.
  * @param out Pointer to the matrix where the transposed matrix will be stored.
- * @note Arguments 'a' and 'out' must not overlap (restrict pointers).
+ * @note Arguments 'a' and 'out' must not overlap (restrict pointers). The
+ * matrix is moved in TRANSPOSE_TILE tiles, each split into 4 x 4 blocks
+ * transposed in SIMD registers, so the strided writes stay within a few pages
+ * at a time.
  * @return ERR_OK on success, or an error code otherwise.
  */
 util_error_t mat_transpose_rc(const mat_t* restrict a, mat_t* restrict out);
 
+/**
+ * @brief Transposes a matrix in place; a rectangular matrix swaps its row and
+ * column counts.
+ * @param m Pointer to the matrix.
+ * @note Square matrices are transposed tile pair by tile pair, in parallel,
+ * with no extra memory. Rectangular ones follow the cycles of the index
+ * permutation, which needs one bit per element (elements / 8 bytes) instead
+ * of a second matrix but runs on one thread with scattered accesses: when
+ * memory allows, mat_transpose_rc into a new matrix is faster.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_transpose_inplace_rc(mat_t* m);
+
 /**
  * @brief Reshapes the matrix to new dimensions.
  * @param m Pointer to the matrix.
@@ -328,17 +575,33 @@ util_error_t mat_reshape_rc(mat_t* restrict m, size_t new_rows,
  * @brief Computes the determinant of the matrix.
  * @param m Pointer to the matrix.
  * @param out Pointer to a double where the determinant will be stored.
+ * @note Computed from a blocked LU factorization with partial pivoting. The
+ * result may overflow for large matrices; see mat_logdet_rc.
  * @note Arguments 'm' and 'out' must not overlap (restrict pointers).
  * @return ERR_OK on success, or an error code otherwise.
  */
 util_error_t mat_det_rc(const mat_t* restrict m, double* restrict out);
 
+/**
+ * @brief Computes the sign and the natural logarithm of the absolute value of
+ * the determinant, so that det(m) = sign * exp(out).
+ * @param m Pointer to the matrix.
+ * @param sign Pointer to a double where the sign (-1, 0 or 1) will be stored.
+ * @param out Pointer to a double where log|det(m)| will be stored. For a
+ * singular matrix, sign is 0 and out is -INFINITY.
+ * @note Arguments 'm', 'sign' and 'out' must not overlap (restrict pointers).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_logdet_rc(const mat_t* restrict m, double* restrict sign,
+                           double* restrict out);
+
 /**
  * @brief Computes the inverse of the matrix.
  * @param m Pointer to the source matrix.
  * @param out Pointer to the matrix where the inverse will be stored.
  * @note Arguments 'm' and 'out' must not overlap (restrict pointers).
- * @return ERR_OK on success, or an error code otherwise.
+ * @return ERR_OK on success, ERR_DIV_ZERO if the matrix is singular, or an
+ * error code otherwise.
  */
 util_error_t mat_inverse_rc(const mat_t* restrict m, mat_t* restrict out);
 
@@ -347,11 +610,142 @@ util_error_t mat_inverse_rc(const mat_t* restrict m, mat_t* restrict out);
  * @param a Pointer to the coefficient matrix.
  * @param b Pointer to the right-hand side vector.
  * @param out Pointer to the vector where the solution will be stored.
+ * @note Factors 'a' on every call. To solve repeatedly against the same
+ * matrix, factor it once with mat_factor_lu_rc (see mat_factor.h).
  * @note Arguments 'a', 'b', and 'out' must not overlap (restrict pointers).
- * @return ERR_OK on success, or an error code otherwise.
+ * @return ERR_OK on success, ERR_DIV_ZERO if the matrix is singular, or an
+ * error code otherwise.
  */
 util_error_t mat_solve_rc(const mat_t* restrict a, const vec_t* restrict b,
                           vec_t* restrict out);
+
+/**
+ * @brief Computes the Cholesky factor L of a symmetric positive definite
+ * matrix, so that m = L * L^T.
+ * @param m Pointer to the source matrix. Only its lower triangle is read.
+ * @param out Pointer to the matrix where L will be stored; its strict upper
+ * triangle is set to zero.
+ * @note Blocked; the trailing updates run as a parallel tiled SYRK and need
+ * about half the flops of an LU factorization.
+ * @note Arguments 'm' and 'out' must not overlap (restrict pointers).
+ * @return ERR_OK on success, ERR_NOT_POSDEF if the matrix is not positive
+ * definite (the contents of 'out' are then unspecified), or an error code
+ * otherwise.
+ */
+util_error_t mat_cholesky_rc(const mat_t* restrict m, mat_t* restrict out);
+
+/**
+ * @brief Solves A * x = b for a symmetric positive definite matrix A using a
+ * Cholesky factorization. Only the lower triangle of A is read.
+ * @param a Pointer to the coefficient matrix.
+ * @param b Pointer to the right-hand side vector.
+ * @param out Pointer to the vector where the solution will be stored.
+ * @note Factors 'a' on every call. To solve repeatedly against the same
+ * matrix, factor it once with mat_factor_cholesky_rc (see mat_factor.h).
+ * @note Arguments 'a', 'b', and 'out' must not overlap (restrict pointers).
+ * @return ERR_OK on success, ERR_NOT_POSDEF if A is not positive definite, or
+ * an error code otherwise.
+ */
+util_error_t mat_solve_spd_rc(const mat_t* restrict a, const vec_t* restrict b,
+                              vec_t* restrict out);
+
+/**
+ * @brief Computes the thin QR factorization a = q * r with Householder
+ * reflections. With k = min(rows, cols), q is rows x k with orthonormal
+ * columns and r is k x cols upper triangular (zeros below the diagonal).
+ * @param a Pointer to the source matrix.
+ * @param q Pointer to the matrix where Q will be stored (rows x k).
+ * @param r Pointer to the matrix where R will be stored (k x cols).
+ * @note Blocked compact-WY: the bulk of the work runs through the GEMM engine.
+ * @note Arguments 'a', 'q', and 'r' must not overlap (restrict pointers).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_qr_rc(const mat_t* restrict a, mat_t* restrict q,
+                       mat_t* restrict r);
+
+/**
+ * @brief Solves the overdetermined system a * x = b in the least-squares
+ * sense (minimizes ||a * x - b||) through a QR factorization of a.
+ * @param a Pointer to the coefficient matrix (rows >= cols, full rank).
+ * @param b Pointer to the right-hand side vector (length rows).
+ * @param out Pointer to the vector where the solution will be stored (length
+ * cols).
+ * @note Unlike solving the normal equations (a^T a) x = a^T b, this does not
+ * square the condition number of a and forms no transpose.
+ * @note Arguments 'a', 'b', and 'out' must not overlap (restrict pointers).
+ * @return ERR_OK on success, ERR_DIV_ZERO if a is exactly rank deficient, or
+ * an error code otherwise.
+ */
+util_error_t mat_lstsq_rc(const mat_t* restrict a, const vec_t* restrict b,
+                          vec_t* restrict out);
+
+/**
+ * @brief Computes the eigenvalues and, optionally, the eigenvectors of a
+ * symmetric matrix.
+ * @param m Pointer to the symmetric matrix. Only its lower triangle is read.
+ * @param values Pointer to the vector where the eigenvalues will be stored in
+ * ascending order (length rows).
+ * @param vectors Pointer to the matrix where the eigenvectors will be stored
+ * as columns, in the order of 'values', or NULL for eigenvalues only.
+ * @note The matrix is reduced to tridiagonal form with blocked Householder
+ * reflections (rank-2k trailing updates through GEMM). Eigenvalues alone come
+ * from implicit QL; eigenvectors from divide-and-conquer, back-transformed
+ * with blocked reflector applications.
+ * @note Arguments 'm', 'values', and 'vectors' must not overlap (restrict
+ * pointers).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_eigh_rc(const mat_t* restrict m, vec_t* restrict values,
+                         mat_t* restrict vectors);
+
+/**
+ * @brief Computes the k largest eigenvalues and, optionally, their
+ * eigenvectors of a symmetric matrix.
+ * @param m Pointer to the symmetric matrix. Only its lower triangle is read.
+ * @param k Number of eigenpairs (1 <= k <= rows).
+ * @param values Pointer to the vector where the eigenvalues will be stored in
+ * descending order (length k).
+ * @param vectors Pointer to the matrix where the eigenvectors will be stored
+ * as columns (rows x k), in the order of 'values', or NULL.
+ * @note After the tridiagonal reduction, the eigenvalues are found by
+ * bisection and the vectors by inverse iteration, so only O(rows * k) work
+ * (plus the back-transformation of k columns) follows the reduction.
+ * @note Arguments 'm', 'values', and 'vectors' must not overlap (restrict
+ * pointers).
+ * @return ERR_OK on success, ERR_RANGE if k is out of range, or an error code
+ * otherwise.
+ */
+util_error_t mat_eigh_topk_rc(const mat_t* restrict m, size_t k,
+                              vec_t* restrict values,
+                              mat_t* restrict vectors);
+
+/**
+ * @brief Computes an approximation of the k largest singular triplets
+ * A ~ U * diag(s) * V^T with a randomized range finder.
+ * @param a Pointer to the input matrix (rows x cols).
+ * @param k Number of singular triplets (1 <= k <= min(rows, cols)).
+ * @param power_iters Number of power iterations. Each one costs two more
+ * passes over 'a' and sharpens the result when the spectrum decays slowly;
+ * 1 or 2 is usually enough, 0 suits rapidly decaying spectra.
+ * @param s Pointer to the vector where the singular values will be stored in
+ * descending order (length k).
+ * @param u Pointer to the matrix where the left singular vectors will be stored
+ * as columns (rows x k), or NULL.
+ * @param v Pointer to the matrix where the right singular vectors will be
+ * stored as columns (cols x k), or NULL.
+ * @note The range of A is sampled with k + SVD_OVERSAMPLE random directions and
+ * orthonormalized by QR; the products with A and the QR factorizations carry
+ * the O(rows * cols * k) work through the GEMM engine, and only a small
+ * (k + SVD_OVERSAMPLE)-order problem is solved exactly (one-sided Jacobi).
+ * The random directions are generated from a fixed seed, so results are
+ * reproducible.
+ * @note Arguments 'a', 's', 'u', and 'v' must not overlap (restrict pointers).
+ * @return ERR_OK on success, ERR_RANGE if k is out of range, or an error code
+ * otherwise.
+ */
+util_error_t mat_svd_topk_rc(const mat_t* restrict a, size_t k,
+                             size_t power_iters, vec_t* restrict s,
+                             mat_t* restrict u, mat_t* restrict v);
 /**
  * @brief Computes the trace of the matrix.
  * @param m Pointer to the matrix.
@@ -400,6 +794,9 @@ util_error_t mat_sum_rc(const mat_t* restrict m, double* restrict out);
  * @param a Pointer to the first matrix.
  * @param b Pointer to the second matrix.
  * @note Arguments 'a' and 'b' must not overlap (restrict pointers).
+ * @note O(1) for large matrices. Small matrices keep their data inline behind
+ * the header: equal shapes swap elements, otherwise the inline data is first
+ * moved to a buffer of its own.
  * @return ERR_OK on success, or an error code otherwise.
  */
 util_error_t mat_swap_rc(mat_t* restrict a, mat_t* restrict b);
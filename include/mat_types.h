@@ -1,8 +1,11 @@
 #ifndef MAT_TYPES_H
 #define MAT_TYPES_H
 
+#include <stdbool.h>
 #include <stddef.h>
 
+#include "util.h"
+
 // Macro for accessing a matrix element
 #define MAT_AT(m, i, j) ((m)->data[(i) * (m)->cols + (j)])
 
@@ -17,6 +20,85 @@ typedef struct mat_t {
   /** @brief Pointer to the dynamicly allocated array of double data (Row-major
    * order). */
   double* data;
+  /** @brief True if 'data' is a separate allocation released together with
+   * the matrix; false for data stored inline behind the header, arena memory or
+   * a borrowed buffer (see mat_wrap_rc). */
+  bool owns_data;
+  /** @brief True if the header was taken from an arena (see arena.h); freeing
+   * the matrix then leaves it to the arena's reset. */
+  bool in_arena;
+  /** @brief Allocator backend that releases 'data' when owns_data is set
+   * (see alloc.h); NULL otherwise. */
+  const struct alloc_backend_t* backend;
 } mat_t;
 
+// Macro for accessing an element of a strided view
+#define MAT_VIEW_AT(v, i, j) \
+  ((v)->data[(ptrdiff_t)(i) * (v)->rs + (ptrdiff_t)(j) * (v)->cs])
+
+/**
+ * @brief Non-owning strided window into matrix storage.
+ *
+ * Element (i, j) lives at data[i * rs + j * cs]. A view of a whole mat_t has
+ * rs = cols and cs = 1; submatrices keep those strides and only move 'data',
+ * and a transposed view swaps them. Views are plain values: they are created
+ * without allocation and never freed, and stay valid only as long as the
+ * storage they point into.
+ */
+typedef struct mat_view_t {
+  /** @brief Number of rows of the window. */
+  size_t rows;
+  /** @brief Number of columns of the window. */
+  size_t cols;
+  /** @brief Row stride in elements (the leading dimension of row-major
+   * storage). */
+  ptrdiff_t rs;
+  /** @brief Column stride in elements. */
+  ptrdiff_t cs;
+  /** @brief Pointer to element (0, 0) of the window (not owned). */
+  double* data;
+} mat_view_t;
+
+/**
+ * @brief Opaque right-hand operand of a matrix product, packed once into the
+ * GEMM engine's panel layout (see mat_pack_rc).
+ */
+typedef struct gemm_packed_t mat_packed_t;
+
+/**
+ * @brief Built-in activations of a GEMM epilogue (see mat_epilogue_t).
+ */
+typedef enum {
+  MAT_ACT_NONE = 0,     ///< 0. Values are left as they are.
+  MAT_ACT_RELU = 1,     ///< 1. max(x, 0).
+  MAT_ACT_CLAMP = 2,    ///< 2. x clamped to [lo, hi].
+  MAT_ACT_TANH = 3,     ///< 3. tanh(x).
+  MAT_ACT_SIGMOID = 4,  ///< 4. 1 / (1 + exp(-x)).
+  MAT_ACT_MAP = 5       ///< 5. The user callback 'map'.
+} mat_activation_t;
+
+/**
+ * @brief Post-processing fused into a matrix product (see mat_gemm_ep_rc).
+ *
+ * Each element of the m x n result C = alpha * op(A) * op(B) + beta * C then
+ * becomes act(C[i][j] + row_bias[i] + col_bias[j]), computed while the tile is
+ * still in cache instead of in separate passes over C. A zero-initialized
+ * descriptor does nothing.
+ */
+typedef struct mat_epilogue_t {
+  /** @brief One value per column (length n) added to every row, or NULL. */
+  const double* col_bias;
+  /** @brief One value per row (length m) added to every column, or NULL. */
+  const double* row_bias;
+  /** @brief Activation applied after the biases. */
+  mat_activation_t act;
+  /** @brief Lower bound of MAT_ACT_CLAMP. */
+  double lo;
+  /** @brief Upper bound of MAT_ACT_CLAMP (lo <= hi). */
+  double hi;
+  /** @brief Function of MAT_ACT_MAP. It is called from several threads at
+   * once and must be thread-safe. */
+  mat_map_func_t map;
+} mat_epilogue_t;
+
 #endif  // MAT_TYPES_H
\ No newline at end of file
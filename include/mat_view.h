@@ -0,0 +1,199 @@
+#ifndef MAT_VIEW_H
+#define MAT_VIEW_H
+
+#include <stddef.h>
+
+#include "mat_types.h"
+#include "util.h"
+#include "vec_types.h"
+
+/* ============================================================ */
+/*                        View Creation                         */
+/* ============================================================ */
+
+/**
+ * @brief Creates a view of a whole matrix.
+ * @param m Pointer to the matrix.
+ * @param out Pointer to the view to fill.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_rc(mat_t* restrict m, mat_view_t* restrict out);
+
+/**
+ * @brief Creates a view of a whole vector.
+ * @param v Pointer to the vector.
+ * @param out Pointer to the view to fill.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t vec_view_rc(vec_t* restrict v, vec_view_t* restrict out);
+
+/**
+ * @brief Creates a view of the block of 'rows' x 'cols' elements starting at
+ * (i0, j0) of another view.
+ * @param v Pointer to the parent view.
+ * @param i0 First row of the block.
+ * @param j0 First column of the block.
+ * @param rows Number of rows of the block.
+ * @param cols Number of columns of the block.
+ * @param out Pointer to the view to fill (may alias 'v').
+ * @return ERR_OK on success, ERR_RANGE if the block exceeds the parent, or an
+ * error code otherwise.
+ */
+util_error_t mat_view_sub_rc(const mat_view_t* v, size_t i0, size_t j0,
+                             size_t rows, size_t cols, mat_view_t* out);
+
+/**
+ * @brief Creates a view of the transpose of another view (strides swapped).
+ * @param v Pointer to the parent view.
+ * @param out Pointer to the view to fill (may alias 'v').
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_transpose_rc(const mat_view_t* v, mat_view_t* out);
+
+/**
+ * @brief Creates a vector view of one row of a matrix view.
+ * @param v Pointer to the matrix view.
+ * @param row Index of the row.
+ * @param out Pointer to the vector view to fill.
+ * @return ERR_OK on success, ERR_RANGE if 'row' is out of bounds, or an error
+ * code otherwise.
+ */
+util_error_t mat_view_row_rc(const mat_view_t* restrict v, size_t row,
+                             vec_view_t* restrict out);
+
+/**
+ * @brief Creates a vector view of one column of a matrix view. No data is
+ * gathered: the column is addressed through the row stride.
+ * @param v Pointer to the matrix view.
+ * @param col Index of the column.
+ * @param out Pointer to the vector view to fill.
+ * @return ERR_OK on success, ERR_RANGE if 'col' is out of bounds, or an error
+ * code otherwise.
+ */
+util_error_t mat_view_col_rc(const mat_view_t* restrict v, size_t col,
+                             vec_view_t* restrict out);
+
+/**
+ * @brief Creates a vector view of the main diagonal of a matrix view.
+ * @param v Pointer to the matrix view.
+ * @param out Pointer to the vector view to fill (min(rows, cols) elements).
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_diag_rc(const mat_view_t* restrict v,
+                              vec_view_t* restrict out);
+
+/* ============================================================ */
+/*                      Matrix View Kernels                     */
+/* ============================================================ */
+
+/**
+ * @brief Copies the elements of one view into another of the same shape.
+ * @param src Pointer to the source view.
+ * @param dst Pointer to the destination view.
+ * @note The windows must not overlap.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_copy_rc(const mat_view_t* restrict src,
+                              const mat_view_t* restrict dst);
+
+/**
+ * @brief Sets every element of a view to a value.
+ * @param v Pointer to the view.
+ * @param val Value to set.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_fill_rc(const mat_view_t* v, double val);
+
+/**
+ * @brief Multiplies every element of a view by a scalar, in place.
+ * @param v Pointer to the view.
+ * @param alpha Scalar multiplier.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_scale_rc(const mat_view_t* v, double alpha);
+
+/**
+ * @brief Computes Y = alpha * X + Y on two views of the same shape.
+ * @param alpha Scalar multiplier of X.
+ * @param x Pointer to the view X.
+ * @param y Pointer to the view Y (updated in place).
+ * @note The windows must not overlap.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_axpy_rc(double alpha, const mat_view_t* restrict x,
+                              const mat_view_t* restrict y);
+
+/**
+ * @brief Computes C = alpha * A * B + beta * C on views.
+ * @param alpha Scalar multiplier of the product.
+ * @param a Pointer to the view A (m x k).
+ * @param b Pointer to the view B (k x n).
+ * @param beta Scalar multiplier of C. If zero, C is not read.
+ * @param c Pointer to the view C (m x n).
+ * @note Runs on the packed GEMM engine, which reads the operands through
+ * their strides, so transposed views and submatrices cost no copies beyond
+ * the engine's own packing. C must not overlap A or B.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_gemm_rc(double alpha, const mat_view_t* a,
+                              const mat_view_t* b, double beta,
+                              const mat_view_t* c);
+
+/**
+ * @brief Computes y = alpha * A * x + beta * y on views.
+ * @param alpha Scalar multiplier of the product.
+ * @param a Pointer to the view A (m x n).
+ * @param x Pointer to the vector view x (length n).
+ * @param beta Scalar multiplier of y. If zero, y is not read.
+ * @param y Pointer to the vector view y (length m).
+ * @note y must not overlap A or x.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t mat_view_gemv_rc(double alpha, const mat_view_t* a,
+                              const vec_view_t* x, double beta,
+                              const vec_view_t* y);
+
+/* ============================================================ */
+/*                      Vector View Kernels                     */
+/* ============================================================ */
+
+/**
+ * @brief Copies the elements of one vector view into another.
+ * @param src Pointer to the source view.
+ * @param dst Pointer to the destination view (same length).
+ * @note The windows must not overlap.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t vec_view_copy_rc(const vec_view_t* restrict src,
+                              const vec_view_t* restrict dst);
+
+/**
+ * @brief Multiplies every element of a vector view by a scalar, in place.
+ * @param v Pointer to the view.
+ * @param alpha Scalar multiplier.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t vec_view_scale_rc(const vec_view_t* v, double alpha);
+
+/**
+ * @brief Computes y = alpha * x + y on vector views.
+ * @param alpha Scalar multiplier of x.
+ * @param x Pointer to the view x.
+ * @param y Pointer to the view y (same length, updated in place).
+ * @note The windows must not overlap.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t vec_view_axpy_rc(double alpha, const vec_view_t* restrict x,
+                              const vec_view_t* restrict y);
+
+/**
+ * @brief Computes the dot product of two vector views.
+ * @param x Pointer to the first view.
+ * @param y Pointer to the second view (same length).
+ * @param out Pointer where the result will be stored.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t vec_view_dot_rc(const vec_view_t* x, const vec_view_t* y,
+                             double* out);
+
+#endif  // MAT_VIEW_H
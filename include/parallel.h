@@ -0,0 +1,90 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+#include "util.h"
+
+/**
+ * @brief Classes of kernels that share a parallel cutoff.
+ *
+ * Below its class threshold a vector or matrix kernel runs its SIMD loop on
+ * the calling thread instead of opening an OpenMP parallel region, whose
+ * fork/join costs microseconds and dominates small calls.
+ */
+typedef enum {
+  PAR_STREAM = 0,       ///< 0. Element-wise kernels (add, scale, axpy, fill, ...).
+  PAR_REDUCE = 1,       ///< 1. Reductions (dot, norms, sums, matrix-vector).
+  PAR_KERNEL_COUNT = 2  ///< 2. Number of classes.
+} par_kernel_t;
+
+/* ============================================================ */
+/*                          Thresholds                          */
+/* ============================================================ */
+
+/**
+ * @brief Returns the number of elements at which kernels of class 'kind'
+ * start splitting work across threads.
+ * @note A threshold set by the current context (see linalg_ctx.h) takes
+ * precedence. Starts at PAR_STREAM_MIN / PAR_REDUCE_MIN (config.h). If the
+ * environment variable LINALG_PAR_TUNING names a file, it is loaded at startup
+ * as par_load_rc would; if it is "calibrate", par_calibrate_rc runs instead.
+ * @return The threshold in elements; SIZE_MAX means always serial.
+ */
+size_t par_threshold(par_kernel_t kind);
+
+/**
+ * @brief Sets the threshold of one kernel class.
+ * @param kind Kernel class.
+ * @param elements Elements at which its kernels go parallel; 0 always
+ * parallelizes, SIZE_MAX never does.
+ * @note Thresholds are process-wide and not synchronized: change them before
+ * other threads call into the library.
+ * @return ERR_OK on success, ERR_INVALID_ARG for an unknown class, or an error
+ * code otherwise.
+ */
+util_error_t par_set_threshold_rc(par_kernel_t kind, size_t elements);
+
+/* ============================================================ */
+/*                         Calibration                          */
+/* ============================================================ */
+
+/**
+ * @brief Measures every threshold on this machine with the current OpenMP
+ * thread count.
+ *
+ * Each class runs a representative kernel serially and in parallel over
+ * doubling sizes; the threshold becomes the first size from which the
+ * parallel loop stays faster. A class that never gains (e.g. with a single
+ * thread) gets SIZE_MAX. Takes a few tens of milliseconds and 24 MiB of
+ * scratch memory.
+ *
+ * @note Run it again after changing the thread count or binding.
+ * @return ERR_OK on success, or an error code otherwise (thresholds are then
+ * left unchanged).
+ */
+util_error_t par_calibrate_rc(void);
+
+/**
+ * @brief Loads thresholds from a tuning file.
+ *
+ * One "<class> <elements>" pair per line, with class "stream" or "reduce";
+ * blank lines and lines starting with '#' are skipped. Classes the file does
+ * not mention keep their threshold.
+ *
+ * @param path Path of the file, as written by par_save_rc.
+ * @return ERR_OK on success, ERR_IO if the file cannot be read,
+ * ERR_INVALID_ARG on a malformed line (nothing is changed then), or an error
+ * code otherwise.
+ */
+util_error_t par_load_rc(const char* path);
+
+/**
+ * @brief Writes the current thresholds to a tuning file for par_load_rc.
+ * @param path Path of the file; it is overwritten.
+ * @return ERR_OK on success, ERR_IO if the file cannot be written, or an
+ * error code otherwise.
+ */
+util_error_t par_save_rc(const char* path);
+
+#endif  // PARALLEL_H
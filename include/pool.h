@@ -0,0 +1,94 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "alloc.h"
+#include "util.h"
+
+/**
+ * @brief Counters of the calling thread's buffer pool.
+ */
+typedef struct pool_stats_t {
+  /** @brief Allocations served from the pool. */
+  size_t hits;
+  /** @brief Allocations that fell through to the allocator backend. */
+  size_t misses;
+  /** @brief Buffers that entered the pool instead of being freed. */
+  size_t releases;
+  /** @brief Cached buffers freed to honour the byte cap or the slot count. */
+  size_t evictions;
+  /** @brief Buffers currently cached. */
+  size_t cached_buffers;
+  /** @brief Bytes currently cached. */
+  size_t cached_bytes;
+} pool_stats_t;
+
+/* ============================================================ */
+/*                        Configuration                         */
+/* ============================================================ */
+
+/**
+ * @brief Enables the buffer pool of the calling thread.
+ *
+ * While enabled, the separately allocated data buffers of matrices and vectors
+ * (those larger than INLINE_DATA_MAX_BYTES) are not freed but cached, bucketed
+ * by their aligned size (get_aligned_size), and a later allocation of the same
+ * size class on the same thread reuses one. Reused buffers are already
+ * faulted in, so repeated large temporaries stop paying for fresh pages.
+ *
+ * @param max_bytes Maximum number of bytes the pool may hold. The oldest
+ * buffers are freed first when a release would exceed it; a buffer larger
+ * than the cap is never cached.
+ * @note Calling it again changes the cap (trimming the cache if needed) and
+ * keeps the statistics.
+ * @return ERR_OK on success, ERR_RANGE if max_bytes is 0, or an error code
+ * otherwise.
+ */
+util_error_t pool_enable_rc(size_t max_bytes);
+
+/**
+ * @brief Frees every cached buffer of the calling thread and disables its
+ * pool. Threads that enabled a pool should call it before they exit.
+ */
+void pool_disable_rc(void);
+
+/**
+ * @brief Frees every cached buffer of the calling thread; the pool stays
+ * enabled.
+ */
+void pool_trim_rc(void);
+
+/**
+ * @brief Reports the counters of the calling thread's pool.
+ * @param out Pointer where the statistics will be stored.
+ * @return ERR_OK on success, or an error code otherwise.
+ */
+util_error_t pool_stats_rc(pool_stats_t* out);
+
+/* ============================================================ */
+/*                   Allocation Hooks (internal)                */
+/* ============================================================ */
+
+/**
+ * @brief Takes a cached buffer able to hold 'bytes' bytes.
+ * @param bytes Bytes the caller will use.
+ * @param backend Backend the buffer must have been allocated by.
+ * @return An ALIGNMENT-aligned buffer of the size class get_aligned_size
+ * assigns to 'bytes', or NULL if the pool is disabled or has none (counted
+ * as a miss when enabled).
+ */
+void* pool_acquire(size_t bytes, const alloc_backend_t* backend);
+
+/**
+ * @brief Offers a buffer to the pool instead of freeing it.
+ * @param p Buffer allocated by 'backend' for the size class of 'bytes', or
+ * obtained from pool_acquire.
+ * @param bytes Bytes of the buffer known to be usable.
+ * @param backend Backend that allocated the buffer; evictions return it there.
+ * @return True if the pool kept the buffer; false if the caller must free it.
+ */
+bool pool_release(void* p, size_t bytes, const alloc_backend_t* backend);
+
+#endif  // POOL_H
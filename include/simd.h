@@ -0,0 +1,68 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stddef.h>
+
+// Number of elements handed to a SIMD kernel per OpenMP loop iteration.
+#define SIMD_CHUNK 4096
+
+// Upper bounds on the GEMM micro-kernel tile over all kernel variants.
+#define SIMD_GEMM_MAX_MR 8
+#define SIMD_GEMM_MAX_NR 16
+
+/**
+ * @brief Table of ISA-specific kernels used by the hot loops of the library.
+ *
+ * One table exists per instruction set (scalar, SSE2, AVX2/FMA, AVX-512). The
+ * best table supported by the running CPU is selected once at startup, so a
+ * single portable binary runs at full speed on every node.
+ * @note Kernels accept aliasing between input and output arrays at the same
+ * index (e.g. out == a), which the in-place operations rely on.
+ */
+typedef struct simd_kernels_t {
+  /** @brief Human-readable name of the instruction set. */
+  const char* name;
+  /** @brief y[i] = a * x[i] + y[i]. */
+  void (*axpy)(size_t n, double a, const double* x, double* y);
+  /** @brief Returns sum of x[i] * y[i]. */
+  double (*dot)(size_t n, const double* x, const double* y);
+  /**
+   * @brief out[r] = sum of a[i] * x[r][i] for r < 4: four dot products that
+   * share one pass over a.
+   */
+  void (*dot4)(size_t n, const double* a, const double* const* x,
+               double* out);
+  /** @brief out[i] = a[i] + b[i]. */
+  void (*add)(size_t n, const double* a, const double* b, double* out);
+  /** @brief out[i] = a[i] - b[i]. */
+  void (*sub)(size_t n, const double* a, const double* b, double* out);
+  /** @brief out[i] = s * x[i]. */
+  void (*scale)(size_t n, double s, const double* x, double* out);
+  /** @brief Rows of the GEMM micro-kernel tile. */
+  size_t gemm_mr;
+  /** @brief Columns of the GEMM micro-kernel tile. */
+  size_t gemm_nr;
+  /**
+   * @brief GEMM micro-kernel: ab = A_sliver * B_sliver over kc steps.
+   * A is packed as kc groups of gemm_mr values, B as kc groups of gemm_nr
+   * values; ab receives the gemm_mr x gemm_nr tile in row-major order.
+   */
+  void (*gemm_kernel)(size_t kc, const double* a, const double* b,
+                      double* ab);
+  /**
+   * @brief 4 x 4 tile transpose: b[j * ldb + i] = a[i * lda + j] for
+   * i, j < 4. The tiles must not overlap.
+   */
+  void (*transpose_4x4)(const double* a, size_t lda, double* b, size_t ldb);
+} simd_kernels_t;
+
+/**
+ * @brief Returns the kernel table selected for the running CPU.
+ * @note The selection happens once, using CPUID feature bits. Setting the
+ * environment variable LINALG_SIMD to "scalar", "sse2", "avx2" or "avx512"
+ * caps the selection at that level; other values are ignored.
+ * @return Pointer to a static kernel table (never NULL).
+ */
+const simd_kernels_t* simd_kernels(void);
+
+#endif  // SIMD_H
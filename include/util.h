@@ -13,9 +13,29 @@ typedef enum {
   ERR_DIM = 3,          ///< 3. Mismatch in sizes, dimensions, or shapes of objects.
   ERR_RANGE = 4,        ///< 4. Index or value outside the valid range.
   ERR_INVALID_ARG = 5,  ///< 5. Invalid argument in the function.
-  ERR_DIV_ZERO = 6      ///< 6. Division by zero.
+  ERR_DIV_ZERO = 6,     ///< 6. Division by zero.
+  ERR_NOT_POSDEF = 7,   ///< 7. Matrix is not positive definite.
+  ERR_NO_CONVERGE = 8,  ///< 8. An iterative method did not converge.
+  ERR_IO = 9            ///< 9. A file could not be read or written.
 } util_error_t;
 
+/**
+ * @brief Ownership of a caller-provided buffer handed to a wrap constructor
+ * (mat_wrap_rc, vec_wrap_rc).
+ */
+typedef enum {
+  OWN_BORROW = 0,  ///< 0. The caller keeps the buffer; it is never freed.
+  OWN_ADOPT = 1    ///< 1. The object takes the buffer and releases it with free().
+} util_ownership_t;
+
+/**
+ * @brief How an operand enters a product (mat_gemm_rc and friends).
+ */
+typedef enum {
+  TRANS_NONE = 0,  ///< 0. The operand is used as stored.
+  TRANS_T = 1      ///< 1. The operand is used transposed, read in place.
+} util_transpose_t;
+
 /**
  * @brief Return the description of the following error.
  * @param code Error code.
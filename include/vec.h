@@ -25,6 +25,16 @@ vec_t* vec_alloc(size_t n);
  */
 vec_t* vec_from_array(const double* data, size_t n);
 
+/**
+ * @brief Creates a vector over a caller-provided buffer without copying it
+ * (see vec_wrap_rc).
+ * @param data Pointer to n doubles.
+ * @param n Number of elements.
+ * @param own OWN_BORROW or OWN_ADOPT.
+ * @return Pointer to the new vector, or NULL on error.
+ */
+vec_t* vec_wrap(double* data, size_t n, util_ownership_t own);
+
 /**
  * @brief Deallocates the memory occupied by the vector.
  * @param v Pointer to the vector to be freed.
@@ -14,6 +14,10 @@
  * @brief Allocates memory for a vector of length n. The vector is uninitialized
  * @param out Double pointer where the newly allocated vector will be stored.
  * @param n Length (dimension) of the vector to allocate.
+ * @note Header and data are allocated as one cache-line-aligned block unless
+ * the data exceeds INLINE_DATA_MAX_BYTES, so a vector of up to 4 elements
+ * occupies a single cache line. If the calling thread has a current arena
+ * (see arena.h), the vector is taken from it.
  * @return ERR_OK on success, or an error code. On error, *out is left
  * unchanged.
  */
@@ -29,9 +33,28 @@ util_error_t vec_alloc_rc(vec_t** out, size_t n);
  */
 util_error_t vec_from_array_rc(const double* data, vec_t** out, size_t n);
 
+/**
+ * @brief Creates a vector over a caller-provided buffer without copying it.
+ * @param data Pointer to n doubles.
+ * @param out Double pointer where the newly allocated vector will be stored.
+ * @param n Number of elements.
+ * @param own OWN_BORROW to leave the buffer with the caller, who must keep it
+ * alive until the vector is freed; OWN_ADOPT to hand it over, in which case it
+ * must come from malloc/aligned_alloc and is released by vec_free_rc.
+ * @note The buffer is used in place when it is ALIGNMENT-aligned. Otherwise it
+ * is copied into an owned aligned buffer (and, for OWN_ADOPT, freed); the
+ * 'owns_data' field of the result tells which happened.
+ * @return ERR_OK on success, or an error code. On error, *out is left
+ * unchanged and an adopted buffer still belongs to the caller.
+ */
+util_error_t vec_wrap_rc(double* data, vec_t** out, size_t n,
+                         util_ownership_t own);
+
 /**
  * @brief Deallocates the memory occupied by the vector.
  * @param v Pointer to the vector to be freed.
+ * @note A borrowed buffer (see vec_wrap_rc) is left to its owner, and memory
+ * taken from an arena (see arena.h) is left to the arena.
  */
 void vec_free_rc(vec_t* v);
 
@@ -361,6 +384,9 @@ util_error_t vec_sum_rc(const vec_t* restrict v, double* restrict out);
  * @brief Swaps the contents of two vectors.
  * @param a Pointer to the first vector.
  * @param b Pointer to the second vector.
+ * @note O(1) for large vectors. Small vectors keep their data inline behind
+ * the header: equal lengths swap elements, otherwise the inline data is first
+ * moved to a buffer of its own.
  * @return ERR_OK on success, or an error code.
  */
 util_error_t vec_swap_rc(vec_t* a, vec_t* b);
@@ -1,6 +1,7 @@
 #ifndef VEC_TYPES_H
 #define VEC_TYPES_H
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /**
@@ -11,6 +12,35 @@ typedef struct vec_t {
   size_t n;
   /** @brief Pointer to the dynamically allocated array of double data. */
   double* data;
+  /** @brief True if 'data' is a separate allocation released together with
+   * the vector; false for data stored inline behind the header, arena memory or
+   * a borrowed buffer (see vec_wrap_rc). */
+  bool owns_data;
+  /** @brief True if the header was taken from an arena (see arena.h); freeing
+   * the vector then leaves it to the arena's reset. */
+  bool in_arena;
+  /** @brief Allocator backend that releases 'data' when owns_data is set
+   * (see alloc.h); NULL otherwise. */
+  const struct alloc_backend_t* backend;
 } vec_t;
 
+// Macro for accessing an element of a strided view
+#define VEC_VIEW_AT(v, i) ((v)->data[(ptrdiff_t)(i) * (v)->inc])
+
+/**
+ * @brief Non-owning strided window into vector or matrix storage.
+ *
+ * Element i lives at data[i * inc], so a vec_t (inc = 1), a matrix row
+ * (inc = 1), a matrix column (inc = row stride) or a diagonal can all be
+ * addressed without copying. Views are plain values and never freed.
+ */
+typedef struct vec_view_t {
+  /** @brief Number of elements. */
+  size_t n;
+  /** @brief Distance between consecutive elements. */
+  ptrdiff_t inc;
+  /** @brief Pointer to element 0 (not owned). */
+  double* data;
+} vec_view_t;
+
 #endif
\ No newline at end of file
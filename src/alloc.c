@@ -0,0 +1,171 @@
+// mmap, madvise and MAP_ANONYMOUS are hidden by -std=c11 otherwise
+#define _DEFAULT_SOURCE
+
+#include "alloc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "simd.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define ALLOC_HAVE_MMAP
+#endif
+
+/* internal helper: round 'bytes' up to a multiple of the power of two 'to' */
+static inline size_t alloc_round(size_t bytes, size_t to) {
+  return (bytes + to - 1) & ~(to - 1);
+}
+
+/* ============================================================ */
+/*                       Built-in Backends                      */
+/* ============================================================ */
+
+static void* alloc_default_alloc(void* ctx, size_t bytes) {
+  (void)ctx;
+  return aligned_alloc(ALIGNMENT, bytes);
+}
+
+static void alloc_default_free(void* ctx, void* p, size_t bytes) {
+  (void)ctx;
+  (void)bytes;
+  free(p);
+}
+
+static void* alloc_hugepage_alloc(void* ctx, size_t bytes) {
+  (void)ctx;
+  if (bytes < ALLOC_HUGEPAGE_MIN) {
+    return aligned_alloc(ALIGNMENT, bytes);
+  }
+
+  if (bytes > SIZE_MAX / 2) {
+    return NULL;
+  }
+
+  const size_t len = alloc_round(bytes, ALLOC_HUGEPAGE_MIN);
+
+#ifdef ALLOC_HAVE_MMAP
+  // Map one huge page more than needed and trim both ends, so the buffer
+  // starts on a huge-page boundary and every page of it can be promoted
+  char* raw = (char*)mmap(NULL, len + ALLOC_HUGEPAGE_MIN,
+                          PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1, 0);
+  if (raw == MAP_FAILED) {
+    return NULL;
+  }
+
+  char* p = (char*)alloc_round((uintptr_t)raw, ALLOC_HUGEPAGE_MIN);
+  const size_t head = (size_t)(p - raw);
+  if (head > 0) {
+    munmap(raw, head);
+  }
+  munmap(p + len, ALLOC_HUGEPAGE_MIN - head);
+
+#ifdef MADV_HUGEPAGE
+  madvise(p, len, MADV_HUGEPAGE);
+#endif
+  return p;
+#else
+  return aligned_alloc(ALLOC_HUGEPAGE_MIN, len);
+#endif
+}
+
+static void alloc_hugepage_free(void* ctx, void* p, size_t bytes) {
+  (void)ctx;
+#ifdef ALLOC_HAVE_MMAP
+  if (bytes >= ALLOC_HUGEPAGE_MIN) {
+    if (p != NULL) {
+      munmap(p, alloc_round(bytes, ALLOC_HUGEPAGE_MIN));
+    }
+    return;
+  }
+#else
+  (void)bytes;
+#endif
+  free(p);
+}
+
+static void* alloc_numa_alloc(void* ctx, size_t bytes) {
+  (void)ctx;
+#ifdef ALLOC_HAVE_MMAP
+  // Pages straight from the kernel have not been touched by anyone yet
+  // (recycled malloc memory may already sit on one node)
+  double* data = (double*)mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if ((void*)data == MAP_FAILED) {
+    return NULL;
+  }
+#else
+  double* data = (double*)aligned_alloc(ALIGNMENT, bytes);
+  if (data == NULL) {
+    return NULL;
+  }
+#endif
+
+  // Same loop and schedule as the element-wise kernels, so each thread faults
+  // in the pages it will later stream through
+  const size_t n = bytes / sizeof(double);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    memset(data + i, 0, len * sizeof(double));
+  }
+
+  return data;
+}
+
+static void alloc_numa_free(void* ctx, void* p, size_t bytes) {
+  (void)ctx;
+#ifdef ALLOC_HAVE_MMAP
+  if (p != NULL) {
+    munmap(p, bytes);
+  }
+#else
+  (void)bytes;
+  free(p);
+#endif
+}
+
+static const alloc_backend_t alloc_default_backend = {
+    "default", alloc_default_alloc, alloc_default_free, NULL};
+
+static const alloc_backend_t alloc_hugepage_backend = {
+    "hugepage", alloc_hugepage_alloc, alloc_hugepage_free, NULL};
+
+static const alloc_backend_t alloc_numa_backend = {
+    "numa", alloc_numa_alloc, alloc_numa_free, NULL};
+
+const alloc_backend_t* alloc_backend_default(void) {
+  return &alloc_default_backend;
+}
+
+const alloc_backend_t* alloc_backend_hugepage(void) {
+  return &alloc_hugepage_backend;
+}
+
+const alloc_backend_t* alloc_backend_numa(void) { return &alloc_numa_backend; }
+
+/* ============================================================ */
+/*                       Backend Selection                      */
+/* ============================================================ */
+
+static const alloc_backend_t* alloc_installed = &alloc_default_backend;
+
+util_error_t alloc_set_backend_rc(const alloc_backend_t* backend) {
+  if (backend == NULL) {
+    backend = &alloc_default_backend;
+  }
+
+  if (backend->alloc == NULL || backend->free == NULL) {
+    return ERR_INVALID_ARG;
+  }
+
+  alloc_installed = backend;
+
+  return ERR_OK;
+}
+
+const alloc_backend_t* alloc_backend(void) { return alloc_installed; }
@@ -0,0 +1,168 @@
+#include "arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "config.h"
+
+typedef struct arena_chunk_t {
+  struct arena_chunk_t* next;
+  size_t size;  // usable bytes after the header
+  size_t used;
+} arena_chunk_t;
+
+struct arena_t {
+  arena_chunk_t* head;     // first chunk; the list is kept across resets
+  arena_chunk_t* current;  // chunk that serves the next allocation
+  size_t chunk_bytes;
+};
+
+// Chunk headers are padded so the usable area starts ALIGNMENT-aligned
+#define ARENA_CHUNK_HEADER \
+  ((sizeof(arena_chunk_t) + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1))
+
+static _Thread_local arena_t* arena_tls_current = NULL;
+
+/* internal helper: round a request up to the allocation granularity */
+static inline size_t arena_round(size_t bytes) {
+  return (bytes + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+}
+
+static inline char* arena_chunk_base(arena_chunk_t* c) {
+  return (char*)c + ARENA_CHUNK_HEADER;
+}
+
+static arena_chunk_t* arena_chunk_new(size_t size) {
+  if (size > SIZE_MAX - ARENA_CHUNK_HEADER) {
+    return NULL;
+  }
+
+  arena_chunk_t* c =
+      (arena_chunk_t*)aligned_alloc(ALIGNMENT, ARENA_CHUNK_HEADER + size);
+  if (c == NULL) {
+    return NULL;
+  }
+
+  c->next = NULL;
+  c->size = size;
+  c->used = 0;
+  return c;
+}
+
+/* ============================================================ */
+/*                      Lifecycle Management                    */
+/* ============================================================ */
+
+util_error_t arena_create_rc(size_t chunk_bytes, arena_t** out) {
+  if (out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (chunk_bytes == 0) {
+    chunk_bytes = ARENA_DEFAULT_CHUNK;
+  }
+
+  if (chunk_bytes > SIZE_MAX / 2) {
+    return ERR_RANGE;
+  }
+
+  arena_t* a = (arena_t*)malloc(sizeof(arena_t));
+  if (a == NULL) {
+    return ERR_ALLOC;
+  }
+
+  a->chunk_bytes = arena_round(chunk_bytes);
+  a->head = arena_chunk_new(a->chunk_bytes);
+  if (a->head == NULL) {
+    free(a);
+    return ERR_ALLOC;
+  }
+  a->current = a->head;
+
+  *out = a;
+  return ERR_OK;
+}
+
+void arena_free_rc(arena_t* a) {
+  if (!a) {
+    return;
+  }
+
+  arena_chunk_t* c = a->head;
+  while (c != NULL) {
+    arena_chunk_t* next = c->next;
+    free(c);
+    c = next;
+  }
+
+  free(a);
+}
+
+util_error_t arena_reset_rc(arena_t* a) {
+  if (a == NULL) {
+    return ERR_NULL;
+  }
+
+  for (arena_chunk_t* c = a->head; c != NULL; c = c->next) {
+    c->used = 0;
+  }
+  a->current = a->head;
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                          Allocation                          */
+/* ============================================================ */
+
+void* arena_alloc(arena_t* a, size_t bytes) {
+  if (a == NULL || bytes > SIZE_MAX / 2) {
+    return NULL;
+  }
+
+  bytes = arena_round(bytes == 0 ? 1 : bytes);
+
+  // Walk forward through the chunks kept from earlier rounds before growing
+  arena_chunk_t* c = a->current;
+  while (c->size - c->used < bytes) {
+    if (c->next == NULL) {
+      const size_t size = (bytes > a->chunk_bytes) ? bytes : a->chunk_bytes;
+      c->next = arena_chunk_new(size);
+      if (c->next == NULL) {
+        return NULL;
+      }
+    }
+    c = c->next;
+  }
+
+  a->current = c;
+  void* p = arena_chunk_base(c) + c->used;
+  c->used += bytes;
+  return p;
+}
+
+util_error_t arena_used_rc(const arena_t* a, size_t* out) {
+  if (a == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  size_t used = 0;
+  for (const arena_chunk_t* c = a->head; c != NULL; c = c->next) {
+    used += c->used;
+  }
+  *out = used;
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                        Current Arena                         */
+/* ============================================================ */
+
+arena_t* arena_set_current(arena_t* a) {
+  arena_t* prev = arena_tls_current;
+  arena_tls_current = a;
+  return prev;
+}
+
+arena_t* arena_current(void) { return arena_tls_current; }
@@ -0,0 +1,978 @@
+#include "decomp.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "gemm.h"
+#include "simd.h"
+
+// Rows below the diagonal before a panel update is split across threads.
+#define DECOMP_PAR_ROWS 512
+
+// Right-hand-side columns processed together by a triangular block solve.
+#define DECOMP_RHS_CHUNK 256
+
+// Sweeps of the one-sided Jacobi SVD before it reports non-convergence.
+#define DECOMP_JACOBI_MAX_SWEEPS 30
+
+static inline size_t decomp_min(size_t a, size_t b) { return a < b ? a : b; }
+
+static void decomp_swap_rows(double* restrict a, double* restrict b,
+                             size_t n) {
+  for (size_t j = 0; j < n; ++j) {
+    double tmp = a[j];
+    a[j] = b[j];
+    b[j] = tmp;
+  }
+}
+
+/* ============================================================ */
+/*                      Triangular Solves                       */
+/* ============================================================ */
+
+/* X := T^{-1} X for a kb x kb lower diagonal block. */
+static void decomp_trsm_diag_lower(size_t kb, size_t nrhs,
+                                   const double* restrict t, ptrdiff_t rst,
+                                   ptrdiff_t cst, bool unit,
+                                   double* restrict x, size_t ldx) {
+  const simd_kernels_t* kern = simd_kernels();
+
+  #pragma omp parallel for schedule(static) if (nrhs > DECOMP_RHS_CHUNK)
+  for (size_t c0 = 0; c0 < nrhs; c0 += DECOMP_RHS_CHUNK) {
+    const size_t len = decomp_min(DECOMP_RHS_CHUNK, nrhs - c0);
+    for (size_t i = 0; i < kb; ++i) {
+      const double* t_row = t + (ptrdiff_t)i * rst;
+      double* x_i = &x[i * ldx + c0];
+      for (size_t j = 0; j < i; ++j) {
+        kern->axpy(len, -t_row[(ptrdiff_t)j * cst], &x[j * ldx + c0], x_i);
+      }
+      if (!unit) {
+        kern->scale(len, 1.0 / t_row[(ptrdiff_t)i * cst], x_i, x_i);
+      }
+    }
+  }
+}
+
+/* X := T^{-1} X for a kb x kb upper diagonal block. */
+static void decomp_trsm_diag_upper(size_t kb, size_t nrhs,
+                                   const double* restrict t, ptrdiff_t rst,
+                                   ptrdiff_t cst, bool unit,
+                                   double* restrict x, size_t ldx) {
+  const simd_kernels_t* kern = simd_kernels();
+
+  #pragma omp parallel for schedule(static) if (nrhs > DECOMP_RHS_CHUNK)
+  for (size_t c0 = 0; c0 < nrhs; c0 += DECOMP_RHS_CHUNK) {
+    const size_t len = decomp_min(DECOMP_RHS_CHUNK, nrhs - c0);
+    for (size_t i = kb; i-- > 0;) {
+      const double* t_row = t + (ptrdiff_t)i * rst;
+      double* x_i = &x[i * ldx + c0];
+      for (size_t j = i + 1; j < kb; ++j) {
+        kern->axpy(len, -t_row[(ptrdiff_t)j * cst], &x[j * ldx + c0], x_i);
+      }
+      if (!unit) {
+        kern->scale(len, 1.0 / t_row[(ptrdiff_t)i * cst], x_i, x_i);
+      }
+    }
+  }
+}
+
+util_error_t decomp_trsm_lower_rc(size_t n, size_t nrhs, const double* t,
+                                  ptrdiff_t rst, ptrdiff_t cst, bool unit,
+                                  double* x, size_t ldx) {
+  for (size_t k0 = 0; k0 < n; k0 += DECOMP_BLOCK) {
+    const size_t kb = decomp_min(DECOMP_BLOCK, n - k0);
+    const size_t below = n - k0 - kb;
+    const double* t_diag = t + (ptrdiff_t)k0 * rst + (ptrdiff_t)k0 * cst;
+
+    decomp_trsm_diag_lower(kb, nrhs, t_diag, rst, cst, unit, &x[k0 * ldx],
+                           ldx);
+
+    if (below > 0) {
+      util_error_t rc = gemm_strided_rc(
+          below, nrhs, kb, -1.0, t_diag + (ptrdiff_t)kb * rst, rst, cst,
+          &x[k0 * ldx], (ptrdiff_t)ldx, 1, 1.0, &x[(k0 + kb) * ldx],
+          (ptrdiff_t)ldx, 1);
+      if (rc != ERR_OK) {
+        return rc;
+      }
+    }
+  }
+
+  return ERR_OK;
+}
+
+util_error_t decomp_trsm_upper_rc(size_t n, size_t nrhs, const double* t,
+                                  ptrdiff_t rst, ptrdiff_t cst, bool unit,
+                                  double* x, size_t ldx) {
+  if (n == 0) {
+    return ERR_OK;
+  }
+
+  for (size_t k0 = ((n - 1) / DECOMP_BLOCK) * DECOMP_BLOCK;;
+       k0 -= DECOMP_BLOCK) {
+    const size_t kb = decomp_min(DECOMP_BLOCK, n - k0);
+    const double* t_col = t + (ptrdiff_t)k0 * cst;
+
+    decomp_trsm_diag_upper(kb, nrhs, t_col + (ptrdiff_t)k0 * rst, rst, cst,
+                           unit, &x[k0 * ldx], ldx);
+
+    if (k0 > 0) {
+      util_error_t rc =
+          gemm_strided_rc(k0, nrhs, kb, -1.0, t_col, rst, cst, &x[k0 * ldx],
+                          (ptrdiff_t)ldx, 1, 1.0, x, (ptrdiff_t)ldx, 1);
+      if (rc != ERR_OK) {
+        return rc;
+      }
+    }
+
+    if (k0 == 0) {
+      break;
+    }
+  }
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                       LU Factorization                       */
+/* ============================================================ */
+
+/* Factors the panel A[k0:n, k0:k0+kb] with partial pivoting. Interchanges
+ * are applied to whole rows, so the L columns to the left and the trailing
+ * columns to the right are permuted consistently. */
+static void decomp_lu_panel(double* a, size_t n, size_t lda, size_t k0,
+                            size_t kb, size_t* piv, bool* singular) {
+  const size_t kend = k0 + kb;
+
+  for (size_t j = k0; j < kend; ++j) {
+    size_t p = j;
+    double best = fabs(a[j * lda + j]);
+    for (size_t i = j + 1; i < n; ++i) {
+      double val = fabs(a[i * lda + j]);
+      if (val > best) {
+        best = val;
+        p = i;
+      }
+    }
+
+    piv[j] = p;
+    if (p != j) {
+      decomp_swap_rows(&a[j * lda], &a[p * lda], n);
+    }
+
+    const double pivot = a[j * lda + j];
+    if (pivot == 0.0) {
+      *singular = true;
+      continue;
+    }
+
+    const double inv_pivot = 1.0 / pivot;
+    const double* restrict u_row = &a[j * lda + j + 1];
+    const size_t width = kend - j - 1;
+
+    #pragma omp parallel for schedule(static) if (n - j > DECOMP_PAR_ROWS)
+    for (size_t i = j + 1; i < n; ++i) {
+      double* restrict row = &a[i * lda + j];
+      const double l_ij = row[0] * inv_pivot;
+      row[0] = l_ij;
+      for (size_t c = 0; c < width; ++c) {
+        row[c + 1] -= l_ij * u_row[c];
+      }
+    }
+  }
+}
+
+util_error_t decomp_lu_rc(double* a, size_t n, size_t lda, size_t* piv,
+                          bool* singular) {
+  *singular = false;
+
+  for (size_t k0 = 0; k0 < n; k0 += DECOMP_BLOCK) {
+    const size_t kb = decomp_min(DECOMP_BLOCK, n - k0);
+    const size_t kend = k0 + kb;
+    const size_t rest = n - kend;
+
+    decomp_lu_panel(a, n, lda, k0, kb, piv, singular);
+
+    if (rest == 0) {
+      break;
+    }
+
+    // U12 = L11^{-1} * A12
+    decomp_trsm_diag_lower(kb, rest, &a[k0 * lda + k0], (ptrdiff_t)lda, 1,
+                           true, &a[k0 * lda + kend], lda);
+
+    // A22 -= L21 * U12
+    util_error_t rc = gemm_strided_rc(
+        rest, rest, kb, -1.0, &a[kend * lda + k0], (ptrdiff_t)lda, 1,
+        &a[k0 * lda + kend], (ptrdiff_t)lda, 1, 1.0, &a[kend * lda + kend],
+        (ptrdiff_t)lda, 1);
+    if (rc != ERR_OK) {
+      return rc;
+    }
+  }
+
+  return ERR_OK;
+}
+
+void decomp_lu_permute(size_t n, size_t nrhs, const size_t* piv, double* x,
+                       size_t ldx) {
+  for (size_t i = 0; i < n; ++i) {
+    if (piv[i] != i) {
+      decomp_swap_rows(&x[i * ldx], &x[piv[i] * ldx], nrhs);
+    }
+  }
+}
+
+void decomp_lu_solve_vec(size_t n, const double* lu, size_t lda,
+                         const size_t* piv, double* x) {
+  const simd_kernels_t* kern = simd_kernels();
+
+  for (size_t i = 0; i < n; ++i) {
+    if (piv[i] != i) {
+      double tmp = x[i];
+      x[i] = x[piv[i]];
+      x[piv[i]] = tmp;
+    }
+  }
+
+  for (size_t i = 1; i < n; ++i) {
+    x[i] -= kern->dot(i, &lu[i * lda], x);
+  }
+
+  for (size_t i = n; i-- > 0;) {
+    const double* row = &lu[i * lda];
+    x[i] = (x[i] - kern->dot(n - i - 1, &row[i + 1], &x[i + 1])) / row[i];
+  }
+}
+
+/* ============================================================ */
+/*                    Cholesky Factorization                    */
+/* ============================================================ */
+
+/* Factors the kb x kb diagonal block in place (unblocked, lower). */
+static util_error_t decomp_cholesky_diag(double* a, size_t kb, size_t lda) {
+  const simd_kernels_t* kern = simd_kernels();
+
+  for (size_t j = 0; j < kb; ++j) {
+    double* row_j = &a[j * lda];
+    const double d = row_j[j] - kern->dot(j, row_j, row_j);
+    if (!(d > 0.0)) {
+      return ERR_NOT_POSDEF;
+    }
+    const double l_jj = sqrt(d);
+    row_j[j] = l_jj;
+
+    for (size_t i = j + 1; i < kb; ++i) {
+      double* row_i = &a[i * lda];
+      row_i[j] = (row_i[j] - kern->dot(j, row_i, row_j)) / l_jj;
+    }
+  }
+
+  return ERR_OK;
+}
+
+/* Copies the rows x cols block src (leading dimension lds) transposed into
+ * dst (leading dimension ldd). */
+static void decomp_transpose(size_t rows, size_t cols, const double* src,
+                             size_t lds, double* dst, size_t ldd) {
+  #pragma omp parallel for schedule(static) if (rows > DECOMP_PAR_ROWS)
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      dst[j * ldd + i] = src[i * lds + j];
+    }
+  }
+}
+
+util_error_t decomp_cholesky_rc(double* a, size_t n, size_t lda) {
+  if (n == 0) {
+    return ERR_OK;
+  }
+
+  // L21^T = L11^{-1} * A21^T is solved on a transposed copy of the panel so
+  // the diagonal solve streams long contiguous rows instead of short dots.
+  double* work = NULL;
+  if (n > DECOMP_BLOCK) {
+    work = (double*)aligned_alloc(ALIGNMENT,
+                                  get_aligned_size(DECOMP_BLOCK * (n - 1)));
+    if (work == NULL) {
+      return ERR_ALLOC;
+    }
+  }
+
+  util_error_t rc = ERR_OK;
+
+  for (size_t k0 = 0; k0 < n; k0 += DECOMP_BLOCK) {
+    const size_t kb = decomp_min(DECOMP_BLOCK, n - k0);
+    const size_t kend = k0 + kb;
+    const size_t rest = n - kend;
+    double* a11 = &a[k0 * lda + k0];
+    double* a21 = &a[kend * lda + k0];
+
+    rc = decomp_cholesky_diag(a11, kb, lda);
+    if (rc != ERR_OK || rest == 0) {
+      break;
+    }
+
+    // L21 = A21 * L11^{-T}
+    decomp_transpose(rest, kb, a21, lda, work, rest);
+    decomp_trsm_diag_lower(kb, rest, a11, (ptrdiff_t)lda, 1, false, work,
+                           rest);
+    decomp_transpose(kb, rest, work, rest, a21, lda);
+
+    // A22 -= L21 * L21^T, lower triangle only
+    rc = gemm_syrk_lower_rc(rest, kb, -1.0, a21, (ptrdiff_t)lda, 1, 1.0,
+                            &a[kend * lda + kend], (ptrdiff_t)lda, 1);
+    if (rc != ERR_OK) {
+      break;
+    }
+  }
+
+  free(work);
+
+  return rc;
+}
+
+void decomp_cholesky_solve_vec(size_t n, const double* l, size_t lda,
+                               double* x) {
+  const simd_kernels_t* kern = simd_kernels();
+
+  // L * y = b
+  for (size_t i = 0; i < n; ++i) {
+    const double* row = &l[i * lda];
+    x[i] = (x[i] - kern->dot(i, row, x)) / row[i];
+  }
+
+  // L^T * x = y, walking the rows of L so every access is contiguous
+  for (size_t i = n; i-- > 0;) {
+    const double* row = &l[i * lda];
+    x[i] /= row[i];
+    kern->axpy(i, -x[i], row, x);
+  }
+}
+
+/* ============================================================ */
+/*                       QR Factorization                       */
+/* ============================================================ */
+
+/* Generates the Householder reflector H = I - tau * v * v^T that maps the
+ * column x (len elements, stride incx) to beta * e_1. On return x[0] holds
+ * beta and x[1:] holds v[1:] (v[0] = 1 is implicit). */
+static double decomp_householder(size_t len, double* x, size_t incx) {
+  // ||x[1:]||, scaled by the largest magnitude to avoid overflow
+  double amax = 0.0;
+  for (size_t i = 1; i < len; ++i) {
+    amax = fmax(amax, fabs(x[i * incx]));
+  }
+
+  if (amax == 0.0) {
+    return 0.0;
+  }
+
+  double ssq = 0.0;
+  for (size_t i = 1; i < len; ++i) {
+    const double r = x[i * incx] / amax;
+    ssq += r * r;
+  }
+  const double xnorm = amax * sqrt(ssq);
+
+  const double alpha = x[0];
+  const double norm = hypot(alpha, xnorm);
+  const double beta = (alpha >= 0.0) ? -norm : norm;
+  const double scale = 1.0 / (alpha - beta);
+
+  for (size_t i = 1; i < len; ++i) {
+    x[i * incx] *= scale;
+  }
+  x[0] = beta;
+
+  return (beta - alpha) / beta;
+}
+
+/* Factors the panel A[k0:m, k0:k0+kb] with unblocked Householder steps. The
+ * reflectors are stored below the diagonal and their scalars in tau. */
+static void decomp_qr_panel(double* a, size_t m, size_t lda, size_t k0,
+                            size_t kb, double* tau, double* w) {
+  const size_t kend = k0 + kb;
+
+  for (size_t j = k0; j < kend; ++j) {
+    double* col = &a[j * lda + j];
+    const double tj = decomp_householder(m - j, col, lda);
+    tau[j] = tj;
+
+    const size_t width = kend - j - 1;
+    if (tj == 0.0 || width == 0) {
+      continue;
+    }
+
+    // Apply H_j to the remaining panel columns: A -= tau * v * (v^T * A)
+    for (size_t c = 0; c < width; ++c) {
+      w[c] = col[c + 1];
+    }
+    for (size_t i = j + 1; i < m; ++i) {
+      const double v_i = a[i * lda + j];
+      const double* row = &a[i * lda + j + 1];
+      for (size_t c = 0; c < width; ++c) {
+        w[c] += v_i * row[c];
+      }
+    }
+
+    for (size_t c = 0; c < width; ++c) {
+      col[c + 1] -= tj * w[c];
+    }
+
+    #pragma omp parallel for schedule(static) if (m - j > DECOMP_PAR_ROWS)
+    for (size_t i = j + 1; i < m; ++i) {
+      double* row = &a[i * lda + j];
+      const double s = tj * row[0];
+      for (size_t c = 0; c < width; ++c) {
+        row[c + 1] -= s * w[c];
+      }
+    }
+  }
+}
+
+/* Copies the reflectors of the panel at (k0, k0) into an explicit mb x kb
+ * row-major V with unit diagonal and zeros above it. */
+static void decomp_qr_copy_v(const double* a, size_t lda, size_t k0, size_t mb,
+                             size_t kb, double* v) {
+  #pragma omp parallel for schedule(static) if (mb > DECOMP_PAR_ROWS)
+  for (size_t i = 0; i < mb; ++i) {
+    const double* row = &a[(k0 + i) * lda + k0];
+    double* v_row = &v[i * kb];
+    for (size_t c = 0; c < kb; ++c) {
+      v_row[c] = (c < i) ? row[c] : (c == i ? 1.0 : 0.0);
+    }
+  }
+}
+
+/* Builds the kb x kb upper triangular T of the compact-WY form
+ * H_0 * ... * H_{kb-1} = I - V * T * V^T from V (mb x kb) and tau. The Gram
+ * matrix V^T * V comes from one GEMM; column j of T is then
+ * T[0:j, j] = -tau_j * T[0:j, 0:j] * (V^T * v_j)[0:j]. */
+static util_error_t decomp_qr_build_t(size_t mb, size_t kb, const double* v,
+                                      const double* tau, double* t,
+                                      double* w) {
+  util_error_t rc = gemm_strided_rc(kb, kb, mb, 1.0, v, 1, (ptrdiff_t)kb, v,
+                                    (ptrdiff_t)kb, 1, 0.0, t, (ptrdiff_t)kb, 1);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  for (size_t j = 0; j < kb; ++j) {
+    for (size_t p = 0; p < j; ++p) {
+      w[p] = t[p * kb + j];
+    }
+    for (size_t p = 0; p < j; ++p) {
+      double acc = 0.0;
+      for (size_t q = p; q < j; ++q) {
+        acc += t[p * kb + q] * w[q];
+      }
+      t[p * kb + j] = -tau[j] * acc;
+    }
+    t[j * kb + j] = tau[j];
+  }
+
+  return ERR_OK;
+}
+
+/* W := T^T * W (trans) or T * W for the kb x kb upper triangular T and a
+ * kb x ncols row-major W, in place. */
+static void decomp_qr_apply_t(size_t kb, const double* t, bool trans,
+                              size_t ncols, double* w) {
+  const simd_kernels_t* kern = simd_kernels();
+
+  #pragma omp parallel for schedule(static) if (ncols > DECOMP_RHS_CHUNK)
+  for (size_t c0 = 0; c0 < ncols; c0 += DECOMP_RHS_CHUNK) {
+    const size_t len = decomp_min(DECOMP_RHS_CHUNK, ncols - c0);
+    if (trans) {
+      // Row i of T^T W only needs rows p <= i, so walk upwards
+      for (size_t i = kb; i-- > 0;) {
+        double* w_i = &w[i * ncols + c0];
+        kern->scale(len, t[i * kb + i], w_i, w_i);
+        for (size_t p = 0; p < i; ++p) {
+          kern->axpy(len, t[p * kb + i], &w[p * ncols + c0], w_i);
+        }
+      }
+    } else {
+      // Row i of T W only needs rows p >= i, so walk downwards
+      for (size_t i = 0; i < kb; ++i) {
+        double* w_i = &w[i * ncols + c0];
+        kern->scale(len, t[i * kb + i], w_i, w_i);
+        for (size_t p = i + 1; p < kb; ++p) {
+          kern->axpy(len, t[i * kb + p], &w[p * ncols + c0], w_i);
+        }
+      }
+    }
+  }
+}
+
+/* C := (I - V * op(T) * V^T) * C for an mb x ncols block C, with op(T) = T^T
+ * when trans is set. w must hold kb * ncols elements. */
+static util_error_t decomp_qr_apply_block(size_t mb, size_t kb,
+                                          const double* v, const double* t,
+                                          bool trans, size_t ncols, double* c,
+                                          size_t ldc, double* w) {
+  // W = V^T * C
+  util_error_t rc = gemm_strided_rc(kb, ncols, mb, 1.0, v, 1, (ptrdiff_t)kb, c,
+                                    (ptrdiff_t)ldc, 1, 0.0, w,
+                                    (ptrdiff_t)ncols, 1);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  decomp_qr_apply_t(kb, t, trans, ncols, w);
+
+  // C -= V * W
+  return gemm_strided_rc(mb, ncols, kb, -1.0, v, (ptrdiff_t)kb, 1, w,
+                         (ptrdiff_t)ncols, 1, 1.0, c, (ptrdiff_t)ldc, 1);
+}
+
+/* internal helper: scratch of the blocked QR routines */
+typedef struct decomp_qr_work_t {
+  double* v;  // m x DECOMP_BLOCK
+  double* w;  // DECOMP_BLOCK x max(ncols, DECOMP_BLOCK)
+  double* t;  // DECOMP_BLOCK x DECOMP_BLOCK
+} decomp_qr_work_t;
+
+static void decomp_qr_work_free(decomp_qr_work_t* work) {
+  free(work->v);
+  free(work->w);
+  free(work->t);
+}
+
+static util_error_t decomp_qr_work_alloc(decomp_qr_work_t* work, size_t m,
+                                         size_t ncols) {
+  if (ncols < DECOMP_BLOCK) {
+    ncols = DECOMP_BLOCK;
+  }
+
+  work->v = (double*)aligned_alloc(ALIGNMENT,
+                                   get_aligned_size(m * DECOMP_BLOCK));
+  work->w = (double*)aligned_alloc(ALIGNMENT,
+                                   get_aligned_size(ncols * DECOMP_BLOCK));
+  work->t = (double*)aligned_alloc(
+      ALIGNMENT, get_aligned_size(DECOMP_BLOCK * DECOMP_BLOCK));
+  if (work->v == NULL || work->w == NULL || work->t == NULL) {
+    decomp_qr_work_free(work);
+    return ERR_ALLOC;
+  }
+
+  return ERR_OK;
+}
+
+util_error_t decomp_qr_rc(double* a, size_t m, size_t n, size_t lda,
+                          double* tau) {
+  const size_t k = decomp_min(m, n);
+  if (k == 0) {
+    return ERR_OK;
+  }
+
+  decomp_qr_work_t work;
+  util_error_t rc = decomp_qr_work_alloc(&work, m, n);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  for (size_t k0 = 0; k0 < k; k0 += DECOMP_BLOCK) {
+    const size_t kb = decomp_min(DECOMP_BLOCK, k - k0);
+    const size_t kend = k0 + kb;
+    const size_t mb = m - k0;
+
+    decomp_qr_panel(a, m, lda, k0, kb, tau, work.w);
+
+    if (kend >= n) {
+      continue;
+    }
+
+    // A[k0:m, kend:n] = H^T * A[k0:m, kend:n] with H = I - V * T * V^T
+    decomp_qr_copy_v(a, lda, k0, mb, kb, work.v);
+    rc = decomp_qr_build_t(mb, kb, work.v, &tau[k0], work.t, work.w);
+    if (rc != ERR_OK) {
+      break;
+    }
+    rc = decomp_qr_apply_block(mb, kb, work.v, work.t, true, n - kend,
+                               &a[k0 * lda + kend], lda, work.w);
+    if (rc != ERR_OK) {
+      break;
+    }
+  }
+
+  decomp_qr_work_free(&work);
+
+  return rc;
+}
+
+void decomp_qr_apply_qt_vec(size_t m, size_t k, const double* qr, size_t lda,
+                            const double* tau, double* x) {
+  for (size_t j = 0; j < k; ++j) {
+    if (tau[j] == 0.0) {
+      continue;
+    }
+
+    double dot = x[j];
+    for (size_t i = j + 1; i < m; ++i) {
+      dot += qr[i * lda + j] * x[i];
+    }
+
+    const double s = tau[j] * dot;
+    x[j] -= s;
+    for (size_t i = j + 1; i < m; ++i) {
+      x[i] -= s * qr[i * lda + j];
+    }
+  }
+}
+
+void decomp_qr_solve_vec(size_t m, size_t n, const double* qr, size_t lda,
+                         const double* tau, double* x) {
+  const simd_kernels_t* kern = simd_kernels();
+
+  decomp_qr_apply_qt_vec(m, n, qr, lda, tau, x);
+
+  // R * x = (Q^T * b)[0:n]
+  for (size_t i = n; i-- > 0;) {
+    const double* row = &qr[i * lda];
+    x[i] = (x[i] - kern->dot(n - i - 1, &row[i + 1], &x[i + 1])) / row[i];
+  }
+}
+
+/* C := Q * C for the m x ncols block C, with Q = H_0 * ... * H_{k-1} applied
+ * from the last block back. If C starts as the leading columns of the
+ * identity, block k0 only touches rows k0:m where the columns before k0 are
+ * still zero, so its update is restricted to columns k0:ncols. */
+static util_error_t decomp_qr_apply_q_blocks(size_t m, size_t k,
+                                             const double* qr, size_t lda,
+                                             const double* tau, size_t ncols,
+                                             double* c, size_t ldc,
+                                             bool identity) {
+  if (k == 0 || ncols == 0) {
+    return ERR_OK;
+  }
+
+  decomp_qr_work_t work;
+  util_error_t rc = decomp_qr_work_alloc(&work, m, ncols);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  for (size_t k0 = ((k - 1) / DECOMP_BLOCK) * DECOMP_BLOCK;;
+       k0 -= DECOMP_BLOCK) {
+    const size_t kb = decomp_min(DECOMP_BLOCK, k - k0);
+    const size_t mb = m - k0;
+    const size_t c0 = identity ? k0 : 0;
+
+    decomp_qr_copy_v(qr, lda, k0, mb, kb, work.v);
+    rc = decomp_qr_build_t(mb, kb, work.v, &tau[k0], work.t, work.w);
+    if (rc != ERR_OK) {
+      break;
+    }
+    rc = decomp_qr_apply_block(mb, kb, work.v, work.t, false, ncols - c0,
+                               &c[k0 * ldc + c0], ldc, work.w);
+    if (rc != ERR_OK || k0 == 0) {
+      break;
+    }
+  }
+
+  decomp_qr_work_free(&work);
+
+  return rc;
+}
+
+util_error_t decomp_qr_apply_q_rc(size_t m, size_t k, const double* qr,
+                                  size_t lda, const double* tau, size_t ncols,
+                                  double* c, size_t ldc) {
+  return decomp_qr_apply_q_blocks(m, k, qr, lda, tau, ncols, c, ldc, false);
+}
+
+util_error_t decomp_qr_form_q_rc(size_t m, size_t k, const double* qr,
+                                 size_t lda, const double* tau, double* q,
+                                 size_t ldq) {
+  for (size_t i = 0; i < m; ++i) {
+    for (size_t j = 0; j < k; ++j) {
+      q[i * ldq + j] = (i == j) ? 1.0 : 0.0;
+    }
+  }
+
+  return decomp_qr_apply_q_blocks(m, k, qr, lda, tau, k, q, ldq, true);
+}
+
+/* ============================================================ */
+/*                 Symmetric Tridiagonal Reduction              */
+/* ============================================================ */
+
+util_error_t decomp_tridiag_rc(double* a, size_t n, size_t lda, double* d,
+                               double* e, double* tau) {
+  if (n == 0) {
+    return ERR_OK;
+  }
+
+  const simd_kernels_t* kern = simd_kernels();
+
+  // Mirror the lower triangle so every row of the trailing matrix is a full
+  // row: the panel's matrix-vector products become contiguous row dots.
+  #pragma omp parallel for schedule(static) if (n > DECOMP_PAR_ROWS)
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      a[j * lda + i] = a[i * lda + j];
+    }
+  }
+
+  // V and W hold the panel's reflectors and the matching update vectors
+  // (rows relative to the panel start), so that the trailing matrix is
+  // A - V * W^T - W * V^T.
+  double* v = (double*)aligned_alloc(ALIGNMENT,
+                                     get_aligned_size(n * DECOMP_BLOCK));
+  double* w = (double*)aligned_alloc(ALIGNMENT,
+                                     get_aligned_size(n * DECOMP_BLOCK));
+  double* y = (double*)aligned_alloc(ALIGNMENT,
+                                     get_aligned_size(n + 2 * DECOMP_BLOCK));
+  if (v == NULL || w == NULL || y == NULL) {
+    free(v);
+    free(w);
+    free(y);
+    return ERR_ALLOC;
+  }
+
+  double* t1 = y + n;
+  double* t2 = t1 + DECOMP_BLOCK;
+  const size_t nb = DECOMP_BLOCK;
+  util_error_t rc = ERR_OK;
+
+  for (size_t k0 = 0; k0 < n; k0 += nb) {
+    const size_t kb = decomp_min(nb, n - k0);
+    const size_t big_n = n - k0;
+
+    for (size_t i = 0; i < kb; ++i) {
+      const size_t c = k0 + i;
+      double* x = &a[c * lda + c];  // row c == column c (rows c:n)
+
+      // Apply the updates of the panel's previous reflectors to column c
+      const size_t rows = big_n - i;
+      if (i > 0) {
+        const double* v_i = &v[i * nb];
+        const double* w_i = &w[i * nb];
+        #pragma omp parallel for schedule(static) if (rows > DECOMP_PAR_ROWS)
+        for (size_t r = i; r < big_n; ++r) {
+          x[r - i] -= kern->dot(i, &v[r * nb], w_i) +
+                      kern->dot(i, &w[r * nb], v_i);
+        }
+      }
+
+      d[c] = x[0];
+
+      const size_t len = rows - 1;
+      if (len == 0) {
+        break;
+      }
+
+      const double tc = decomp_householder(len, &x[1], 1);
+      tau[c] = tc;
+      e[c] = x[1];
+      x[1] = 1.0;
+
+      const double* vc = &x[1];
+      for (size_t r = 1; r < len; ++r) {
+        a[(c + 1 + r) * lda + c] = vc[r];
+      }
+
+      // y = tau * (A22 - V * W^T - W * V^T) * v
+      const double* a22 = &a[(c + 1) * lda + c + 1];
+      #pragma omp parallel for schedule(static) if (len > DECOMP_PAR_ROWS)
+      for (size_t r = 0; r < len; ++r) {
+        y[r] = kern->dot(len, &a22[r * lda], vc);
+      }
+
+      if (i > 0) {
+        for (size_t p = 0; p < i; ++p) {
+          t1[p] = 0.0;
+          t2[p] = 0.0;
+        }
+        for (size_t r = 0; r < len; ++r) {
+          kern->axpy(i, vc[r], &w[(i + 1 + r) * nb], t1);
+          kern->axpy(i, vc[r], &v[(i + 1 + r) * nb], t2);
+        }
+        #pragma omp parallel for schedule(static) if (len > DECOMP_PAR_ROWS)
+        for (size_t r = 0; r < len; ++r) {
+          y[r] -= kern->dot(i, &v[(i + 1 + r) * nb], t1) +
+                  kern->dot(i, &w[(i + 1 + r) * nb], t2);
+        }
+      }
+
+      kern->scale(len, tc, y, y);
+      kern->axpy(len, -0.5 * tc * kern->dot(len, y, vc), vc, y);
+
+      for (size_t r = 0; r <= i; ++r) {
+        v[r * nb + i] = 0.0;
+        w[r * nb + i] = 0.0;
+      }
+      for (size_t r = 0; r < len; ++r) {
+        v[(i + 1 + r) * nb + i] = vc[r];
+        w[(i + 1 + r) * nb + i] = y[r];
+      }
+
+      x[1] = e[c];
+    }
+
+    const size_t kend = k0 + kb;
+    if (kend >= n) {
+      break;
+    }
+
+    // A22 -= V * W^T + W * V^T, kept in full so its rows stay complete
+    const size_t rest = n - kend;
+    double* a22 = &a[kend * lda + kend];
+    rc = gemm_strided_rc(rest, rest, kb, -1.0, &v[kb * nb], (ptrdiff_t)nb, 1,
+                         &w[kb * nb], 1, (ptrdiff_t)nb, 1.0, a22,
+                         (ptrdiff_t)lda, 1);
+    if (rc == ERR_OK) {
+      rc = gemm_strided_rc(rest, rest, kb, -1.0, &w[kb * nb], (ptrdiff_t)nb,
+                           1, &v[kb * nb], 1, (ptrdiff_t)nb, 1.0, a22,
+                           (ptrdiff_t)lda, 1);
+    }
+    if (rc != ERR_OK) {
+      break;
+    }
+  }
+
+  free(v);
+  free(w);
+  free(y);
+
+  return rc;
+}
+
+/* ============================================================ */
+/*                 Singular Value Decomposition                 */
+/* ============================================================ */
+
+util_error_t decomp_svd_jacobi_rc(size_t r, size_t c, double* g, size_t ldg,
+                                  double* s, double* u, size_t ldu) {
+  if (r == 0) {
+    return ERR_OK;
+  }
+
+  if (r > c) {
+    return ERR_DIM;
+  }
+
+  // Rows of ut are the columns of U; they receive the same rotations as the
+  // rows of G so that G = U * G' holds throughout.
+  double* ut = (double*)malloc(r * r * sizeof(double));
+  size_t* order = (size_t*)malloc(r * sizeof(size_t));
+  if (ut == NULL || order == NULL) {
+    free(ut);
+    free(order);
+    return ERR_ALLOC;
+  }
+
+  for (size_t i = 0; i < r * r; ++i) {
+    ut[i] = 0.0;
+  }
+  for (size_t i = 0; i < r; ++i) {
+    ut[i * r + i] = 1.0;
+  }
+
+  const simd_kernels_t* kern = simd_kernels();
+  util_error_t rc = ERR_NO_CONVERGE;
+
+  for (int sweep = 0; sweep < DECOMP_JACOBI_MAX_SWEEPS; ++sweep) {
+    bool rotated = false;
+
+    for (size_t p = 0; p + 1 < r; ++p) {
+      double* gp = &g[p * ldg];
+      for (size_t q = p + 1; q < r; ++q) {
+        double* gq = &g[q * ldg];
+        const double alpha = kern->dot(c, gp, gp);
+        const double beta = kern->dot(c, gq, gq);
+        const double gamma = kern->dot(c, gp, gq);
+
+        if (fabs(gamma) <= DBL_EPSILON * sqrt(alpha * beta)) {
+          continue;
+        }
+        rotated = true;
+
+        // Rotation that makes rows p and q orthogonal
+        const double zeta = (beta - alpha) / (2.0 * gamma);
+        const double t = copysign(1.0, zeta) /
+                         (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+        const double cs = 1.0 / sqrt(1.0 + t * t);
+        const double sn = cs * t;
+
+        for (size_t j = 0; j < c; ++j) {
+          const double xp = gp[j];
+          const double xq = gq[j];
+          gp[j] = cs * xp - sn * xq;
+          gq[j] = sn * xp + cs * xq;
+        }
+
+        double* up = &ut[p * r];
+        double* uq = &ut[q * r];
+        for (size_t j = 0; j < r; ++j) {
+          const double xp = up[j];
+          const double xq = uq[j];
+          up[j] = cs * xp - sn * xq;
+          uq[j] = sn * xp + cs * xq;
+        }
+      }
+    }
+
+    if (!rotated) {
+      rc = ERR_OK;
+      break;
+    }
+  }
+
+  if (rc == ERR_OK) {
+    // Singular values are the row norms; sort them in descending order
+    for (size_t i = 0; i < r; ++i) {
+      const double* gi = &g[i * ldg];
+      s[i] = sqrt(kern->dot(c, gi, gi));
+      order[i] = i;
+    }
+    for (size_t i = 1; i < r; ++i) {
+      const size_t oi = order[i];
+      size_t j = i;
+      while (j > 0 && s[order[j - 1]] < s[oi]) {
+        order[j] = order[j - 1];
+        --j;
+      }
+      order[j] = oi;
+    }
+
+    // Columns of U are gathered directly; rows of G are permuted in place by
+    // following the cycles of the permutation
+    for (size_t i = 0; i < r; ++i) {
+      for (size_t j = 0; j < r; ++j) {
+        u[i * ldu + j] = ut[order[j] * r + i];
+      }
+    }
+    for (size_t start = 0; start < r; ++start) {
+      if (order[start] == start || order[start] == SIZE_MAX) {
+        continue;
+      }
+      size_t cur = start;
+      while (order[cur] != start) {
+        const size_t next = order[cur];
+        decomp_swap_rows(&g[cur * ldg], &g[next * ldg], c);
+        const double tmp = s[cur];
+        s[cur] = s[next];
+        s[next] = tmp;
+        order[cur] = SIZE_MAX;
+        cur = next;
+      }
+      order[cur] = SIZE_MAX;
+    }
+    for (size_t i = 0; i < r; ++i) {
+      if (s[i] > 0.0) {
+        kern->scale(c, 1.0 / s[i], &g[i * ldg], &g[i * ldg]);
+      }
+    }
+  }
+
+  free(ut);
+  free(order);
+
+  return rc;
+}
@@ -0,0 +1,726 @@
+#include "eigen.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "gemm.h"
+#include "simd.h"
+
+// Subproblems up to this order are solved by QL instead of being split.
+#define EIGEN_DC_LEAF 32
+
+// Iteration limits of the QL sweeps (per eigenvalue), of the secular equation
+// solver (per root) and of inverse iteration (per eigenvector).
+#define EIGEN_QL_MAX_ITER 60
+#define EIGEN_SECULAR_MAX_ITER 200
+#define EIGEN_INVIT_ITER 3
+
+// Roots of the secular equation / eigenvalues solved per parallel loop before
+// the loop is split across threads.
+#define EIGEN_PAR_MIN 64
+
+// Eigenvalues closer than this fraction of ||T|| are treated as a cluster
+// whose inverse-iteration vectors are reorthogonalized against each other.
+#define EIGEN_CLUSTER_TOL 1e-3
+
+typedef struct eigen_pair_t {
+  double value;
+  size_t index;
+} eigen_pair_t;
+
+static int eigen_pair_cmp(const void* a, const void* b) {
+  const double x = ((const eigen_pair_t*)a)->value;
+  const double y = ((const eigen_pair_t*)b)->value;
+  return (x > y) - (x < y);
+}
+
+/* ============================================================ */
+/*                          Implicit QL                         */
+/* ============================================================ */
+
+util_error_t eigen_tridiag_ql_rc(size_t n, double* d, const double* e,
+                                 double* z, size_t ldz) {
+  if (n == 0) {
+    return ERR_OK;
+  }
+
+  // Off-diagonal with a trailing zero: sub[i] couples rows i and i + 1
+  double* sub = (double*)malloc(n * sizeof(double));
+  if (sub == NULL) {
+    return ERR_ALLOC;
+  }
+  if (n > 1) {
+    memcpy(sub, e, (n - 1) * sizeof(double));
+  }
+  sub[n - 1] = 0.0;
+
+  util_error_t rc = ERR_OK;
+
+  for (size_t l = 0; l < n && rc == ERR_OK; ++l) {
+    int iter = 0;
+    size_t m;
+
+    do {
+      for (m = l; m + 1 < n; ++m) {
+        const double dd = fabs(d[m]) + fabs(d[m + 1]);
+        if (fabs(sub[m]) <= DBL_EPSILON * dd) {
+          break;
+        }
+      }
+
+      if (m == l) {
+        break;
+      }
+
+      if (iter++ == EIGEN_QL_MAX_ITER) {
+        rc = ERR_NO_CONVERGE;
+        break;
+      }
+
+      // Wilkinson-type shift from the leading 2 x 2 block
+      double g = (d[l + 1] - d[l]) / (2.0 * sub[l]);
+      double r = hypot(g, 1.0);
+      g = d[m] - d[l] + sub[l] / (g + copysign(r, g));
+
+      double s = 1.0;
+      double c = 1.0;
+      double p = 0.0;
+      bool underflow = false;
+
+      for (size_t i = m; i-- > l;) {
+        double f = s * sub[i];
+        const double b = c * sub[i];
+        r = hypot(f, g);
+        sub[i + 1] = r;
+
+        if (r == 0.0) {
+          d[i + 1] -= p;
+          sub[m] = 0.0;
+          underflow = true;
+          break;
+        }
+
+        s = f / r;
+        c = g / r;
+        g = d[i + 1] - p;
+        r = (d[i] - g) * s + 2.0 * c * b;
+        p = s * r;
+        d[i + 1] = g + p;
+        g = c * r - b;
+
+        if (z != NULL) {
+          for (size_t k = 0; k < n; ++k) {
+            double* z_row = &z[k * ldz];
+            f = z_row[i + 1];
+            z_row[i + 1] = s * z_row[i] + c * f;
+            z_row[i] = c * z_row[i] - s * f;
+          }
+        }
+      }
+
+      if (underflow) {
+        continue;
+      }
+
+      d[l] -= p;
+      sub[l] = g;
+      sub[m] = 0.0;
+    } while (m != l);
+  }
+
+  free(sub);
+
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  // Selection sort: at most n - 1 column swaps
+  for (size_t i = 0; i + 1 < n; ++i) {
+    size_t k = i;
+    for (size_t j = i + 1; j < n; ++j) {
+      if (d[j] < d[k]) {
+        k = j;
+      }
+    }
+    if (k == i) {
+      continue;
+    }
+
+    const double tmp = d[i];
+    d[i] = d[k];
+    d[k] = tmp;
+
+    if (z != NULL) {
+      for (size_t r = 0; r < n; ++r) {
+        double* z_row = &z[r * ldz];
+        const double t = z_row[i];
+        z_row[i] = z_row[k];
+        z_row[k] = t;
+      }
+    }
+  }
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                      Divide and Conquer                      */
+/* ============================================================ */
+
+/* internal helper: scratch shared by all merges of one solve */
+typedef struct eigen_dc_work_t {
+  double* gather;  // n x n: eigenvector columns of the halves, reordered
+  double* vecs;    // n x n: eigenvectors of the rank-one problem (by rows)
+} eigen_dc_work_t;
+
+/* Solves the secular equation 1 + rho * sum z_i^2 / (delta_i - lambda) = 0
+ * for its j-th root, delta ascending. The root is returned as
+ * lambda = delta[*origin] + tau relative to the nearer pole, so that the
+ * differences delta_i - lambda can be formed without cancellation. */
+static double eigen_secular_root(size_t k, const double* delta,
+                                 const double* z, double rho, size_t j,
+                                 size_t* origin) {
+  size_t o = j;
+  double lo = 0.0;
+  double hi = 0.0;
+
+  if (j + 1 < k) {
+    const double gap = delta[j + 1] - delta[j];
+    const double mid = 0.5 * gap;
+    double f = 1.0;
+    for (size_t i = 0; i < k; ++i) {
+      f += rho * z[i] * z[i] / ((delta[i] - delta[j]) - mid);
+    }
+    if (f >= 0.0) {
+      hi = mid;
+    } else {
+      o = j + 1;
+      lo = -mid;
+    }
+  } else {
+    double zz = 0.0;
+    for (size_t i = 0; i < k; ++i) {
+      zz += z[i] * z[i];
+    }
+    hi = rho * zz * (1.0 + 4.0 * DBL_EPSILON);
+  }
+
+  const double base = delta[o];
+  double tau = 0.5 * (lo + hi);
+
+  for (int iter = 0; iter < EIGEN_SECULAR_MAX_ITER; ++iter) {
+    double g = 1.0;
+    double dg = 0.0;
+    for (size_t i = 0; i < k; ++i) {
+      const double diff = (delta[i] - base) - tau;
+      const double t = z[i] / diff;
+      g += rho * z[i] * t;
+      dg += rho * t * t;
+    }
+
+    if (g == 0.0) {
+      break;
+    }
+    if (g < 0.0) {
+      lo = tau;
+    } else {
+      hi = tau;
+    }
+
+    double next = tau - g / dg;
+    if (!(next > lo && next < hi)) {
+      next = 0.5 * (lo + hi);
+    }
+
+    const double step = fabs(next - tau);
+    tau = next;
+    if (step <= 2.0 * DBL_EPSILON * fabs(tau) ||
+        hi - lo <= 2.0 * DBL_EPSILON * fmax(fabs(lo), fabs(hi))) {
+      break;
+    }
+  }
+
+  *origin = o;
+  return tau;
+}
+
+/* Merges the solved halves [0, m) and [m, n) of a torn tridiagonal matrix.
+ * On entry d holds the eigenvalues of both halves (each ascending) and the
+ * diagonal blocks of q their eigenvectors; the coupling is rho * u * u^T with
+ * u = e_{m-1} + sign(rho) * e_m. On return d and q hold the eigenpairs of the
+ * whole matrix in ascending order. */
+static util_error_t eigen_dc_merge(size_t n, size_t m, double* d, double rho,
+                                   double* q, size_t ldq,
+                                   eigen_dc_work_t* work) {
+  double* dbuf = (double*)malloc(5 * n * sizeof(double));
+  size_t* ibuf = (size_t*)malloc(2 * n * sizeof(size_t));
+  eigen_pair_t* pairs = (eigen_pair_t*)malloc(n * sizeof(eigen_pair_t));
+  if (dbuf == NULL || ibuf == NULL || pairs == NULL) {
+    free(dbuf);
+    free(ibuf);
+    free(pairs);
+    return ERR_ALLOC;
+  }
+
+  double* dd = dbuf;          // poles in ascending order
+  double* zz = dbuf + n;      // matching components of z
+  double* lam = dbuf + 2 * n; // eigenvalue of each output column
+  double* tau = dbuf + 3 * n; // secular roots relative to their origin
+  double* zhat = dbuf + 4 * n;
+  size_t* col = ibuf;         // column of q behind each sorted pole
+  size_t* org = ibuf + n;     // origin pole of each secular root
+
+  // z = blkdiag(Q1, Q2)^T * u, scaled to unit norm (rho absorbs the factor 2)
+  const double sgn = (rho < 0.0) ? -1.0 : 1.0;
+  const double beta = 2.0 * fabs(rho);
+  const double inv_sqrt2 = 1.0 / sqrt(2.0);
+
+  // Merge the two ascending halves
+  size_t a = 0;
+  size_t b = m;
+  for (size_t t = 0; t < n; ++t) {
+    const size_t i = (b >= n || (a < m && d[a] <= d[b])) ? a++ : b++;
+    col[t] = i;
+    dd[t] = d[i];
+    zz[t] = (i < m) ? q[(m - 1) * ldq + i] * inv_sqrt2
+                    : sgn * q[m * ldq + i] * inv_sqrt2;
+  }
+
+  // Deflation: negligible z components, then pairs of close poles that a
+  // Givens rotation reduces to one
+  double dmax = 0.0;
+  double zmax = 0.0;
+  for (size_t t = 0; t < n; ++t) {
+    dmax = fmax(dmax, fabs(dd[t]));
+    zmax = fmax(zmax, fabs(zz[t]));
+  }
+  const double tol = 8.0 * DBL_EPSILON * fmax(dmax, zmax);
+
+  bool* deflated = (bool*)zhat;  // reused before zhat is needed
+  size_t prev = n;
+  for (size_t t = 0; t < n; ++t) {
+    deflated[t] = beta * fabs(zz[t]) <= tol;
+    if (deflated[t]) {
+      continue;
+    }
+
+    if (prev < n) {
+      const double r = hypot(zz[t], zz[prev]);
+      const double c = zz[t] / r;
+      const double s = zz[prev] / r;
+      const double diff = dd[t] - dd[prev];
+
+      if (fabs(diff * c * s) <= tol) {
+        const size_t ci = col[prev];
+        const size_t cj = col[t];
+        for (size_t row = 0; row < n; ++row) {
+          double* q_row = &q[row * ldq];
+          const double qa = q_row[ci];
+          const double qb = q_row[cj];
+          q_row[ci] = c * qa - s * qb;
+          q_row[cj] = s * qa + c * qb;
+        }
+
+        const double di = dd[prev];
+        const double dj = dd[t];
+        dd[prev] = di * c * c + dj * s * s;
+        dd[t] = di * s * s + dj * c * c;
+        zz[t] = r;
+        zz[prev] = 0.0;
+        deflated[prev] = true;
+      }
+    }
+    prev = t;
+  }
+
+  // Compact: non-deflated poles first (still ascending), deflated after
+  size_t k = 0;
+  for (size_t t = 0; t < n; ++t) {
+    if (!deflated[t]) {
+      pairs[k].value = dd[t];
+      pairs[k].index = t;
+      ++k;
+    }
+  }
+  size_t nd = k;
+  for (size_t t = 0; t < n; ++t) {
+    if (deflated[t]) {
+      pairs[nd].value = dd[t];
+      pairs[nd].index = t;
+      ++nd;
+    }
+  }
+  for (size_t t = 0; t < n; ++t) {
+    const size_t src = pairs[t].index;
+    lam[t] = dd[src];
+    tau[t] = zz[src];
+    org[t] = col[src];
+  }
+  memcpy(dd, lam, n * sizeof(double));
+  memcpy(zz, tau, n * sizeof(double));
+  memcpy(col, org, n * sizeof(size_t));
+
+  // Gather the eigenvectors of the halves in the compacted order
+  double* gather = work->gather;
+  #pragma omp parallel for schedule(static) if (n > EIGEN_PAR_MIN)
+  for (size_t row = 0; row < n; ++row) {
+    const double* q_row = &q[row * ldq];
+    double* g_row = &gather[row * n];
+    for (size_t t = 0; t < n; ++t) {
+      g_row[t] = q_row[col[t]];
+    }
+  }
+
+  // Roots of the secular equation, one per non-deflated pole
+  #pragma omp parallel for schedule(static) if (k > EIGEN_PAR_MIN)
+  for (size_t j = 0; j < k; ++j) {
+    tau[j] = eigen_secular_root(k, dd, zz, beta, j, &org[j]);
+  }
+
+  // Gu-Eisenstat: recompute z from the computed roots so that the
+  // eigenvectors below are orthogonal to working precision
+  #pragma omp parallel for schedule(static) if (k > EIGEN_PAR_MIN)
+  for (size_t i = 0; i < k; ++i) {
+    double p = ((dd[org[k - 1]] - dd[i]) + tau[k - 1]) / beta;
+    for (size_t j = 0; j < i; ++j) {
+      p *= ((dd[org[j]] - dd[i]) + tau[j]) / (dd[j] - dd[i]);
+    }
+    for (size_t j = i; j + 1 < k; ++j) {
+      p *= ((dd[org[j]] - dd[i]) + tau[j]) / (dd[j + 1] - dd[i]);
+    }
+    zhat[i] = copysign(sqrt(fabs(p)), zz[i]);
+  }
+
+  // Row j of vecs is the j-th eigenvector of D + beta * z * z^T
+  double* vecs = work->vecs;
+  #pragma omp parallel for schedule(static) if (k > EIGEN_PAR_MIN)
+  for (size_t j = 0; j < k; ++j) {
+    double* v = &vecs[j * k];
+    double norm = 0.0;
+    for (size_t i = 0; i < k; ++i) {
+      v[i] = zhat[i] / ((dd[i] - dd[org[j]]) - tau[j]);
+      norm += v[i] * v[i];
+    }
+    const double inv = 1.0 / sqrt(norm);
+    for (size_t i = 0; i < k; ++i) {
+      v[i] *= inv;
+    }
+  }
+
+  for (size_t j = 0; j < k; ++j) {
+    lam[j] = dd[org[j]] + tau[j];
+  }
+  for (size_t t = k; t < n; ++t) {
+    lam[t] = dd[t];
+  }
+
+  // q[:, 0:k] = gather[:, 0:k] * vecs^T, deflated columns pass through
+  util_error_t rc = ERR_OK;
+  if (k > 0) {
+    rc = gemm_strided_rc(n, k, k, 1.0, gather, (ptrdiff_t)n, 1, vecs, 1,
+                         (ptrdiff_t)k, 0.0, q, (ptrdiff_t)ldq, 1);
+  }
+
+  if (rc == ERR_OK) {
+    for (size_t t = 0; t < n; ++t) {
+      pairs[t].value = lam[t];
+      pairs[t].index = t;
+    }
+    qsort(pairs, n, sizeof(eigen_pair_t), eigen_pair_cmp);
+
+    for (size_t t = 0; t < n; ++t) {
+      d[t] = pairs[t].value;
+    }
+
+    // Permute the columns into ascending order, one row at a time
+    #pragma omp parallel for schedule(static) if (n > EIGEN_PAR_MIN)
+    for (size_t row = 0; row < n; ++row) {
+      double* q_row = &q[row * ldq];
+      double* g_row = &gather[row * n];
+      for (size_t t = k; t < n; ++t) {
+        q_row[t] = g_row[t];
+      }
+      memcpy(g_row, q_row, n * sizeof(double));
+      for (size_t t = 0; t < n; ++t) {
+        q_row[t] = g_row[pairs[t].index];
+      }
+    }
+  }
+
+  free(dbuf);
+  free(ibuf);
+  free(pairs);
+
+  return rc;
+}
+
+static util_error_t eigen_dc(size_t n, double* d, const double* e, double* q,
+                             size_t ldq, eigen_dc_work_t* work) {
+  if (n <= EIGEN_DC_LEAF) {
+    for (size_t i = 0; i < n; ++i) {
+      double* q_row = &q[i * ldq];
+      memset(q_row, 0, n * sizeof(double));
+      q_row[i] = 1.0;
+    }
+    return eigen_tridiag_ql_rc(n, d, e, q, ldq);
+  }
+
+  // Tear T = blkdiag(T1, T2) + |rho| * u * u^T
+  const size_t m = n / 2;
+  const double rho = e[m - 1];
+  d[m - 1] -= fabs(rho);
+  d[m] -= fabs(rho);
+
+  for (size_t i = 0; i < m; ++i) {
+    memset(&q[i * ldq + m], 0, (n - m) * sizeof(double));
+  }
+  for (size_t i = m; i < n; ++i) {
+    memset(&q[i * ldq], 0, m * sizeof(double));
+  }
+
+  util_error_t rc = eigen_dc(m, d, e, q, ldq, work);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+  rc = eigen_dc(n - m, d + m, e + m, &q[m * ldq + m], ldq, work);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  return eigen_dc_merge(n, m, d, rho, q, ldq, work);
+}
+
+util_error_t eigen_tridiag_dc_rc(size_t n, double* d, const double* e,
+                                 double* z, size_t ldz) {
+  if (n == 0) {
+    return ERR_OK;
+  }
+
+  eigen_dc_work_t work = {NULL, NULL};
+  if (n > EIGEN_DC_LEAF) {
+    work.gather = (double*)aligned_alloc(ALIGNMENT, get_aligned_size(n * n));
+    work.vecs = (double*)aligned_alloc(ALIGNMENT, get_aligned_size(n * n));
+    if (work.gather == NULL || work.vecs == NULL) {
+      free(work.gather);
+      free(work.vecs);
+      return ERR_ALLOC;
+    }
+  }
+
+  util_error_t rc = eigen_dc(n, d, e, z, ldz, &work);
+
+  free(work.gather);
+  free(work.vecs);
+
+  return rc;
+}
+
+/* ============================================================ */
+/*               Bisection and Inverse Iteration                */
+/* ============================================================ */
+
+/* Number of eigenvalues of T smaller than x (Sturm sequence count). */
+static size_t eigen_sturm_count(size_t n, const double* d, const double* e,
+                                double x, double pivmin) {
+  size_t count = 0;
+  double q = d[0] - x;
+
+  for (size_t i = 0;; ++i) {
+    if (fabs(q) < pivmin) {
+      q = -pivmin;
+    }
+    if (q < 0.0) {
+      ++count;
+    }
+    if (i + 1 == n) {
+      break;
+    }
+    q = (d[i + 1] - x) - e[i] * e[i] / q;
+  }
+
+  return count;
+}
+
+/* Solves (T - lambda * I) * y = y in place with a tridiagonal LU factorization
+ * with partial pivoting. Tiny pivots are replaced by +-eps * ||T||, which
+ * makes the solve well defined at an eigenvalue. */
+static void eigen_invit_solve(size_t n, const double* d, const double* e,
+                              double lambda, double tnorm, double* y,
+                              double* work) {
+  double* p = work;          // diagonal of U
+  double* u1 = work + n;     // first superdiagonal of U
+  double* u2 = work + 2 * n; // second superdiagonal of U (from interchanges)
+  double* mult = work + 3 * n;
+  bool* swap = (bool*)(work + 4 * n);
+
+  const double small = DBL_EPSILON * tnorm;
+
+  double diag = d[0] - lambda;
+  double up = (n > 1) ? e[0] : 0.0;
+
+  for (size_t i = 0; i + 1 < n; ++i) {
+    const double lo = e[i];
+    const double next_diag = d[i + 1] - lambda;
+    const double next_up = (i + 2 < n) ? e[i + 1] : 0.0;
+
+    if (fabs(diag) >= fabs(lo)) {
+      const double mu = (diag == 0.0) ? 0.0 : lo / diag;
+      p[i] = diag;
+      u1[i] = up;
+      u2[i] = 0.0;
+      mult[i] = mu;
+      swap[i] = false;
+      diag = next_diag - mu * up;
+      up = next_up;
+    } else {
+      const double mu = diag / lo;
+      p[i] = lo;
+      u1[i] = next_diag;
+      u2[i] = next_up;
+      mult[i] = mu;
+      swap[i] = true;
+      diag = up - mu * next_diag;
+      up = -mu * next_up;
+    }
+  }
+  p[n - 1] = diag;
+
+  for (size_t i = 0; i < n; ++i) {
+    if (fabs(p[i]) < small) {
+      p[i] = (p[i] < 0.0) ? -small : small;
+    }
+  }
+
+  for (size_t i = 0; i + 1 < n; ++i) {
+    if (swap[i]) {
+      const double t = y[i];
+      y[i] = y[i + 1];
+      y[i + 1] = t;
+    }
+    y[i + 1] -= mult[i] * y[i];
+  }
+
+  for (size_t i = n; i-- > 0;) {
+    double acc = y[i];
+    if (i + 1 < n) {
+      acc -= u1[i] * y[i + 1];
+    }
+    if (i + 2 < n) {
+      acc -= u2[i] * y[i + 2];
+    }
+    y[i] = acc / p[i];
+  }
+}
+
+util_error_t eigen_tridiag_select_rc(size_t n, const double* d,
+                                     const double* e, size_t il, size_t count,
+                                     double* w, double* z, size_t ldz) {
+  if (count == 0) {
+    return ERR_OK;
+  }
+
+  if (il + count > n) {
+    return ERR_RANGE;
+  }
+
+  // Gershgorin interval and the norm used for tolerances
+  double lo = d[0];
+  double hi = d[0];
+  double tnorm = 0.0;
+  double emax = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    const double left = (i > 0) ? fabs(e[i - 1]) : 0.0;
+    const double right = (i + 1 < n) ? fabs(e[i]) : 0.0;
+    lo = fmin(lo, d[i] - left - right);
+    hi = fmax(hi, d[i] + left + right);
+    tnorm = fmax(tnorm, fabs(d[i]) + left + right);
+    emax = fmax(emax, right * right);
+  }
+  if (tnorm == 0.0) {
+    tnorm = 1.0;
+  }
+  const double pivmin = DBL_MIN * fmax(1.0, emax);
+
+  #pragma omp parallel for schedule(static) if (count > EIGEN_PAR_MIN)
+  for (size_t j = 0; j < count; ++j) {
+    const size_t target = il + j;
+    double a = lo;
+    double b = hi;
+    while (b - a > 2.0 * DBL_EPSILON * fmax(fabs(a), fabs(b)) + pivmin) {
+      const double mid = 0.5 * (a + b);
+      if (mid <= a || mid >= b) {
+        break;
+      }
+      if (eigen_sturm_count(n, d, e, mid, pivmin) <= target) {
+        a = mid;
+      } else {
+        b = mid;
+      }
+    }
+    w[j] = 0.5 * (a + b);
+  }
+
+  if (z == NULL) {
+    return ERR_OK;
+  }
+
+  double* y = (double*)malloc(n * sizeof(double));
+  double* work = (double*)malloc(5 * n * sizeof(double));
+  if (y == NULL || work == NULL) {
+    free(y);
+    free(work);
+    return ERR_ALLOC;
+  }
+
+  const simd_kernels_t* kern = simd_kernels();
+  const double cluster_gap = EIGEN_CLUSTER_TOL * tnorm;
+  size_t cluster_start = 0;
+  unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+
+  for (size_t j = 0; j < count; ++j) {
+    if (j > 0 && w[j] - w[j - 1] > cluster_gap) {
+      cluster_start = j;
+    }
+
+    // Separate coincident eigenvalues slightly so their vectors differ
+    double lambda = w[j];
+    if (j > cluster_start && lambda - w[j - 1] < 10.0 * DBL_EPSILON * tnorm) {
+      lambda = w[j - 1] + 10.0 * DBL_EPSILON * tnorm;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      y[i] = (double)(seed >> 11) / 9007199254740992.0 - 0.5;
+    }
+
+    for (int iter = 0; iter < EIGEN_INVIT_ITER; ++iter) {
+      eigen_invit_solve(n, d, e, lambda, tnorm, y, work);
+
+      for (size_t c = cluster_start; c < j; ++c) {
+        double dot = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+          dot += z[i * ldz + c] * y[i];
+        }
+        for (size_t i = 0; i < n; ++i) {
+          y[i] -= dot * z[i * ldz + c];
+        }
+      }
+
+      const double norm = sqrt(kern->dot(n, y, y));
+      kern->scale(n, 1.0 / norm, y, y);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      z[i * ldz + j] = y[i];
+    }
+  }
+
+  free(y);
+  free(work);
+
+  return ERR_OK;
+}
@@ -0,0 +1,777 @@
+#include "gemm.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "alloc.h"
+#include "config.h"
+#include "linalg_ctx.h"
+#include "simd.h"
+
+// Rows per strip when a diagonal SYRK tile is split so that only its lower
+// triangle is written.
+#define GEMM_SYRK_STRIP 32
+
+// Largest order with a dedicated fixed-size kernel for square products. Above
+// it the runtime-dispatched micro-kernel on stack-packed operands is faster.
+#define GEMM_SMALL_SQUARE_MAX 7
+
+static inline size_t gemm_min(size_t a, size_t b) { return a < b ? a : b; }
+
+static inline size_t gemm_round_up(size_t x, size_t m) {
+  return (x + m - 1) / m * m;
+}
+
+/* ============================================================ */
+/*                          Workspace                           */
+/* ============================================================ */
+
+// Packing buffers of the calling thread, kept between products
+typedef struct {
+  double* buf;
+  size_t bytes;
+  const alloc_backend_t* backend;  // allocated 'buf'; frees it too
+} gemm_workspace_t;
+
+static _Thread_local gemm_workspace_t gemm_tls_workspace;
+
+#ifdef _OPENMP
+// Largest team the calling thread has opened on work that runs the engine on
+// its workers (SYRK tiles, batched products); 0 if none since the last trim
+static _Thread_local int gemm_tls_team;
+#endif
+
+/* internal helper: record that the team about to be opened by the calling
+ * thread leaves workspaces on its workers */
+static void gemm_note_team(void) {
+#ifdef _OPENMP
+  if (!omp_in_parallel() && omp_get_max_threads() > gemm_tls_team) {
+    gemm_tls_team = omp_get_max_threads();
+  }
+#endif
+}
+
+/* internal helper: free the calling thread's workspace */
+static void gemm_workspace_release(void) {
+  gemm_workspace_t* ws = &gemm_tls_workspace;
+  if (ws->buf != NULL) {
+    ws->backend->free(ws->backend->ctx, ws->buf, ws->bytes);
+  }
+  ws->buf = NULL;
+  ws->bytes = 0;
+  ws->backend = NULL;
+}
+
+/* internal helper: the scratch of the current context, or else the calling
+ * thread's workspace, grown to hold at least 'elements' doubles; NULL if it
+ * cannot be grown */
+static double* gemm_workspace(size_t elements) {
+  const size_t bytes = get_aligned_size(elements);
+  double* scratch = (double*)linalg_ctx_scratch(bytes);
+  if (scratch != NULL) {
+    return scratch;
+  }
+
+  gemm_workspace_t* ws = &gemm_tls_workspace;
+  if (bytes <= ws->bytes) {
+    return ws->buf;
+  }
+
+  gemm_workspace_release();
+
+  const alloc_backend_t* backend = alloc_backend();
+  ws->buf = (double*)backend->alloc(backend->ctx, bytes);
+  if (ws->buf == NULL) {
+    return NULL;
+  }
+  ws->bytes = bytes;
+  ws->backend = backend;
+  return ws->buf;
+}
+
+void gemm_trim_rc(void) {
+  gemm_workspace_release();
+
+#ifdef _OPENMP
+  // The workers are reached through a team as large as the largest one that
+  // left workspaces on them, whatever the thread count is now
+  const int team = gemm_tls_team;
+  if (team > 1 && !omp_in_parallel()) {
+    #pragma omp parallel num_threads(team)
+    gemm_workspace_release();
+    gemm_tls_team = 0;
+  }
+#endif
+}
+
+/* ============================================================ */
+/*                           Packing                            */
+/* ============================================================ */
+
+// A k x n operand packed in the order the driver consumes it: for each
+// GEMM_NC column block, its GEMM_KC row panels, each laid out exactly as the
+// per-call B packing would produce it.
+struct gemm_packed_t {
+  size_t k;
+  size_t n;
+  const simd_kernels_t* kern;  // the layout depends on its gemm_nr
+  double* data;
+  size_t bytes;
+  const alloc_backend_t* backend;  // allocated 'data'; frees it too
+};
+
+/* internal helper: panel of rows [pc, pc + kc) of column block jc */
+static const double* gemm_packed_panel(const gemm_packed_t* bp, size_t jc,
+                                       size_t pc, size_t nc) {
+  const size_t nr_tile = bp->kern->gemm_nr;
+  const size_t block_cols = gemm_round_up(GEMM_NC, nr_tile);
+  return bp->data + (jc / GEMM_NC) * block_cols * bp->k +
+         pc * gemm_round_up(nc, nr_tile);
+}
+
+/* Packs an mc x kc block of A into MR-row slivers. Each sliver stores kc
+ * columns of MR contiguous values; rows past mc are zero-padded so the
+ * micro-kernel never needs an edge case. */
+static void gemm_pack_a(size_t mc, size_t kc, size_t mr_tile,
+                        const double* restrict a, ptrdiff_t rsa, ptrdiff_t csa,
+                        double* restrict buf) {
+  for (size_t ir = 0; ir < mc; ir += mr_tile) {
+    const size_t mr = gemm_min(mr_tile, mc - ir);
+    const double* restrict sliver = a + (ptrdiff_t)ir * rsa;
+
+    for (size_t p = 0; p < kc; ++p) {
+      const double* restrict col = sliver + (ptrdiff_t)p * csa;
+      size_t i = 0;
+      for (; i < mr; ++i) {
+        buf[i] = col[(ptrdiff_t)i * rsa];
+      }
+      for (; i < mr_tile; ++i) {
+        buf[i] = 0.0;
+      }
+      buf += mr_tile;
+    }
+  }
+}
+
+/* Packs a kc x nr sliver of B (nr <= NR) into kc rows of NR contiguous
+ * values, zero-padding columns past nr. */
+static void gemm_pack_b(size_t kc, size_t nr, size_t nr_tile,
+                        const double* restrict b, ptrdiff_t rsb, ptrdiff_t csb,
+                        double* restrict buf) {
+  for (size_t p = 0; p < kc; ++p) {
+    const double* restrict row = b + (ptrdiff_t)p * rsb;
+    size_t j = 0;
+    for (; j < nr; ++j) {
+      buf[j] = row[(ptrdiff_t)j * csb];
+    }
+    for (; j < nr_tile; ++j) {
+      buf[j] = 0.0;
+    }
+    buf += nr_tile;
+  }
+}
+
+/* ============================================================ */
+/*                        Compute Kernels                       */
+/* ============================================================ */
+
+/* Applies an epilogue to 'len' finished values of row i of C, starting at
+ * column j0: biases first, then the activation. */
+static void gemm_epilogue_row(const mat_epilogue_t* ep, size_t i, size_t j0,
+                              size_t len, double* restrict c, ptrdiff_t csc) {
+  if (ep->row_bias != NULL || ep->col_bias != NULL) {
+    const double rb = (ep->row_bias != NULL) ? ep->row_bias[i] : 0.0;
+    for (size_t j = 0; j < len; ++j) {
+      const double cb = (ep->col_bias != NULL) ? ep->col_bias[j0 + j] : 0.0;
+      c[(ptrdiff_t)j * csc] += rb + cb;
+    }
+  }
+
+  switch (ep->act) {
+    case MAT_ACT_RELU:
+      for (size_t j = 0; j < len; ++j) {
+        double* c_ij = &c[(ptrdiff_t)j * csc];
+        *c_ij = (*c_ij > 0.0) ? *c_ij : 0.0;
+      }
+      break;
+    case MAT_ACT_CLAMP:
+      for (size_t j = 0; j < len; ++j) {
+        double* c_ij = &c[(ptrdiff_t)j * csc];
+        *c_ij = (*c_ij < ep->lo) ? ep->lo : (*c_ij > ep->hi) ? ep->hi : *c_ij;
+      }
+      break;
+    case MAT_ACT_TANH:
+      for (size_t j = 0; j < len; ++j) {
+        double* c_ij = &c[(ptrdiff_t)j * csc];
+        *c_ij = tanh(*c_ij);
+      }
+      break;
+    case MAT_ACT_SIGMOID:
+      for (size_t j = 0; j < len; ++j) {
+        double* c_ij = &c[(ptrdiff_t)j * csc];
+        *c_ij = 1.0 / (1.0 + exp(-*c_ij));
+      }
+      break;
+    case MAT_ACT_MAP:
+      for (size_t j = 0; j < len; ++j) {
+        double* c_ij = &c[(ptrdiff_t)j * csc];
+        *c_ij = ep->map(*c_ij);
+      }
+      break;
+    case MAT_ACT_NONE:
+    default:
+      break;
+  }
+}
+
+/* Writes the top-left mr x nr part of a computed tile into C as
+ * C = alpha * ab + beta * C. C is not read when beta is zero. When 'ep' is
+ * given the tile is final and each row goes through the epilogue while still
+ * in L1; (i0, j0) is the tile's position in the whole C. */
+static void gemm_store_tile(size_t mr, size_t nr, size_t nr_tile,
+                            double alpha, const double* restrict ab,
+                            double beta, double* restrict c, ptrdiff_t rsc,
+                            ptrdiff_t csc, const mat_epilogue_t* ep, size_t i0,
+                            size_t j0) {
+  for (size_t i = 0; i < mr; ++i) {
+    double* restrict c_row = c + (ptrdiff_t)i * rsc;
+    const double* restrict ab_row = ab + i * nr_tile;
+
+    if (beta == 0.0) {
+      for (size_t j = 0; j < nr; ++j) {
+        c_row[(ptrdiff_t)j * csc] = alpha * ab_row[j];
+      }
+    } else {
+      for (size_t j = 0; j < nr; ++j) {
+        double* c_ij = &c_row[(ptrdiff_t)j * csc];
+        *c_ij = alpha * ab_row[j] + beta * *c_ij;
+      }
+    }
+
+    if (ep != NULL) {
+      gemm_epilogue_row(ep, i0 + i, j0, nr, c_row, csc);
+    }
+  }
+}
+
+/* Multiplies a packed mc x kc block of A by a packed kc x nc panel of B and
+ * updates the corresponding mc x nc block of C, which starts at (i0, j0) of the
+ * whole C. The B sliver is reused from L1 across all A slivers of the block. */
+static void gemm_macro_kernel(const simd_kernels_t* kern, size_t mc, size_t nc,
+                              size_t kc, double alpha,
+                              const double* restrict a_pack,
+                              const double* restrict b_pack, double beta,
+                              double* restrict c, ptrdiff_t rsc, ptrdiff_t csc,
+                              const mat_epilogue_t* ep, size_t i0, size_t j0) {
+  _Alignas(64) double ab[SIMD_GEMM_MAX_MR * SIMD_GEMM_MAX_NR];
+  const size_t mr_tile = kern->gemm_mr;
+  const size_t nr_tile = kern->gemm_nr;
+
+  for (size_t jr = 0; jr < nc; jr += nr_tile) {
+    const size_t nr = gemm_min(nr_tile, nc - jr);
+    const double* restrict b_sliver = b_pack + jr * kc;
+
+    for (size_t ir = 0; ir < mc; ir += mr_tile) {
+      const size_t mr = gemm_min(mr_tile, mc - ir);
+      const double* restrict a_sliver = a_pack + ir * kc;
+
+      kern->gemm_kernel(kc, a_sliver, b_sliver, ab);
+      gemm_store_tile(mr, nr, nr_tile, alpha, ab, beta,
+                      c + (ptrdiff_t)ir * rsc + (ptrdiff_t)jr * csc, rsc, csc,
+                      ep, i0 + ir, j0 + jr);
+    }
+  }
+}
+
+/* C = beta * C, used when the product term vanishes; the epilogue, if any,
+ * still applies. */
+static void gemm_scale_c(size_t m, size_t n, double beta, double* restrict c,
+                         ptrdiff_t rsc, ptrdiff_t csc,
+                         const mat_epilogue_t* ep) {
+  for (size_t i = 0; i < m; ++i) {
+    double* restrict c_row = c + (ptrdiff_t)i * rsc;
+    for (size_t j = 0; j < n; ++j) {
+      double* c_ij = &c_row[(ptrdiff_t)j * csc];
+      *c_ij = (beta == 0.0) ? 0.0 : beta * *c_ij;
+    }
+    if (ep != NULL) {
+      gemm_epilogue_row(ep, i, 0, n, c_row, csc);
+    }
+  }
+}
+
+/* internal helper: validate an epilogue descriptor */
+static util_error_t gemm_epilogue_check(const mat_epilogue_t* ep) {
+  switch (ep->act) {
+    case MAT_ACT_NONE:
+    case MAT_ACT_RELU:
+    case MAT_ACT_TANH:
+    case MAT_ACT_SIGMOID:
+      return ERR_OK;
+    case MAT_ACT_CLAMP:
+      return (ep->lo <= ep->hi) ? ERR_OK : ERR_INVALID_ARG;
+    case MAT_ACT_MAP:
+      return (ep->map != NULL) ? ERR_OK : ERR_NULL;
+    default:
+      return ERR_INVALID_ARG;
+  }
+}
+
+/* ============================================================ */
+/*                        Small Products                        */
+/* ============================================================ */
+
+/* Finishes row i of a small product from its n accumulators. */
+static inline void gemm_small_store(size_t n, double alpha,
+                                    const double* restrict acc, double beta,
+                                    double* restrict c_row, ptrdiff_t csc,
+                                    const mat_epilogue_t* ep, size_t i) {
+  if (beta == 0.0) {
+    for (size_t j = 0; j < n; ++j) {
+      c_row[(ptrdiff_t)j * csc] = alpha * acc[j];
+    }
+  } else {
+    for (size_t j = 0; j < n; ++j) {
+      double* c_ij = &c_row[(ptrdiff_t)j * csc];
+      *c_ij = alpha * acc[j] + beta * *c_ij;
+    }
+  }
+
+  if (ep != NULL) {
+    gemm_epilogue_row(ep, i, 0, n, c_row, csc);
+  }
+}
+
+/* Any product with m, n, k <= GEMM_SMALL_MAX: a single block of the engine,
+ * packed into stack buffers and run on the calling thread. */
+static void gemm_small(size_t m, size_t n, size_t k, double alpha,
+                       const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                       const double* b, ptrdiff_t rsb, ptrdiff_t csb,
+                       double beta, double* c, ptrdiff_t rsc, ptrdiff_t csc,
+                       const mat_epilogue_t* ep) {
+  _Alignas(64) double a_pack[(GEMM_SMALL_MAX + SIMD_GEMM_MAX_MR) *
+                             GEMM_SMALL_MAX];
+  _Alignas(64) double b_pack[(GEMM_SMALL_MAX + SIMD_GEMM_MAX_NR) *
+                             GEMM_SMALL_MAX];
+  const simd_kernels_t* kern = simd_kernels();
+  const size_t nr_tile = kern->gemm_nr;
+
+  gemm_pack_a(m, k, kern->gemm_mr, a, rsa, csa, a_pack);
+  for (size_t jr = 0; jr < n; jr += nr_tile) {
+    gemm_pack_b(k, gemm_min(nr_tile, n - jr), nr_tile,
+                b + (ptrdiff_t)jr * csb, rsb, csb, b_pack + jr * k);
+  }
+
+  gemm_macro_kernel(kern, m, n, k, alpha, a_pack, b_pack, beta, c, rsc, csc,
+                    ep, 0, 0);
+}
+
+typedef void (*gemm_small_square_fn)(double alpha, const double* restrict a,
+                                     ptrdiff_t lda, const double* restrict b,
+                                     ptrdiff_t ldb, double beta,
+                                     double* restrict c, ptrdiff_t ldc,
+                                     const mat_epilogue_t* ep);
+
+/* N x N product of row-major operands (unit column strides) with N fixed at
+ * compile time, so every loop is fully unrolled and the rows of B are
+ * processed in registers. */
+#define GEMM_SMALL_SQUARE(N)                                                  \
+  static void gemm_small_##N(double alpha, const double* restrict a,          \
+                             ptrdiff_t lda, const double* restrict b,         \
+                             ptrdiff_t ldb, double beta, double* restrict c,  \
+                             ptrdiff_t ldc, const mat_epilogue_t* ep) {       \
+    for (size_t i = 0; i < N; ++i) {                                          \
+      double acc[N] = {0.0};                                                  \
+      for (size_t p = 0; p < N; ++p) {                                        \
+        const double a_ip = a[(ptrdiff_t)i * lda + (ptrdiff_t)p];             \
+        for (size_t j = 0; j < N; ++j) {                                      \
+          acc[j] += a_ip * b[(ptrdiff_t)p * ldb + (ptrdiff_t)j];              \
+        }                                                                     \
+      }                                                                       \
+      gemm_small_store(N, alpha, acc, beta, c + (ptrdiff_t)i * ldc, 1, ep, i); \
+    }                                                                         \
+  }
+
+GEMM_SMALL_SQUARE(2)
+GEMM_SMALL_SQUARE(3)
+GEMM_SMALL_SQUARE(4)
+GEMM_SMALL_SQUARE(5)
+GEMM_SMALL_SQUARE(6)
+GEMM_SMALL_SQUARE(7)
+
+static const gemm_small_square_fn
+    gemm_small_square[GEMM_SMALL_SQUARE_MAX + 1] = {
+        NULL,         NULL,         gemm_small_2, gemm_small_3,
+        gemm_small_4, gemm_small_5, gemm_small_6, gemm_small_7};
+
+/* ============================================================ */
+/*                          Public API                          */
+/* ============================================================ */
+
+/* internal helper: the blocked driver. B is either read through its strides
+ * and packed panel by panel, or, when 'bp' is given, taken pre-packed. */
+static util_error_t gemm_run(size_t m, size_t n, size_t k, double alpha,
+                             const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                             const double* b, ptrdiff_t rsb, ptrdiff_t csb,
+                             const gemm_packed_t* bp, double beta, double* c,
+                             ptrdiff_t rsc, ptrdiff_t csc,
+                             const mat_epilogue_t* ep) {
+  if (ep != NULL) {
+    util_error_t rc = gemm_epilogue_check(ep);
+    if (rc != ERR_OK) {
+      return rc;
+    }
+  }
+
+  if (m == 0 || n == 0) {
+    return ERR_OK;
+  }
+
+  if (k == 0 || alpha == 0.0) {
+    gemm_scale_c(m, n, beta, c, rsc, csc, ep);
+    return ERR_OK;
+  }
+
+  // Small products never allocate or open a parallel region
+  if (bp == NULL && m <= GEMM_SMALL_MAX && n <= GEMM_SMALL_MAX &&
+      k <= GEMM_SMALL_MAX) {
+    if (m == n && n == k && m <= GEMM_SMALL_SQUARE_MAX && m >= 2 &&
+        csa == 1 && csb == 1 && csc == 1) {
+      gemm_small_square[m](alpha, a, rsa, b, rsb, beta, c, rsc, ep);
+    } else {
+      gemm_small(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc,
+                 ep);
+    }
+    return ERR_OK;
+  }
+
+  const simd_kernels_t* kern = (bp != NULL) ? bp->kern : simd_kernels();
+  const size_t mr_tile = kern->gemm_mr;
+  const size_t nr_tile = kern->gemm_nr;
+
+  // Called from inside a parallel region (e.g. one tile of a SYRK), the
+  // product runs on the calling thread only.
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_in_parallel() ? 1 : omp_get_max_threads();
+#endif
+
+  // One workspace holds the A slivers of every thread, then the B panel
+  // unless B comes pre-packed
+  const size_t a_pack_elems = GEMM_MC * GEMM_KC;
+  const size_t a_buf_elems = gemm_round_up(a_pack_elems * (size_t)nthreads,
+                                           ALIGNMENT / sizeof(double));
+  size_t b_pack_elems = 0;
+  if (bp == NULL) {
+    b_pack_elems = GEMM_KC * gemm_round_up(gemm_min(n, GEMM_NC), nr_tile);
+  }
+
+  double* a_buf = gemm_workspace(a_buf_elems + b_pack_elems);
+  if (a_buf == NULL) {
+    return ERR_ALLOC;
+  }
+  double* b_buf = a_buf + a_buf_elems;
+
+  #pragma omp parallel num_threads(nthreads)
+  {
+    int tid = 0;
+#ifdef _OPENMP
+    tid = omp_get_thread_num();
+#endif
+    double* restrict a_pack = a_buf + (size_t)tid * a_pack_elems;
+
+    for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+      const size_t nc = gemm_min(GEMM_NC, n - jc);
+
+      for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+        const size_t kc = gemm_min(GEMM_KC, k - pc);
+        const double beta_pc = (pc == 0) ? beta : 1.0;
+        // Only the last panel leaves C final, so it alone runs the epilogue
+        const mat_epilogue_t* ep_pc = (pc + kc == k) ? ep : NULL;
+        const double* b_pack = b_buf;
+
+        if (bp != NULL) {
+          b_pack = gemm_packed_panel(bp, jc, pc, nc);
+        } else {
+          const double* b_panel =
+              b + (ptrdiff_t)pc * rsb + (ptrdiff_t)jc * csb;
+
+          #pragma omp for schedule(static)
+          for (size_t jr = 0; jr < nc; jr += nr_tile) {
+            gemm_pack_b(kc, gemm_min(nr_tile, nc - jr), nr_tile,
+                        b_panel + (ptrdiff_t)jr * csb, rsb, csb,
+                        b_buf + jr * kc);
+          }
+        }
+
+        #pragma omp for schedule(static)
+        for (size_t ic = 0; ic < m; ic += GEMM_MC) {
+          const size_t mc = gemm_min(GEMM_MC, m - ic);
+
+          gemm_pack_a(mc, kc, mr_tile,
+                      a + (ptrdiff_t)ic * rsa + (ptrdiff_t)pc * csa, rsa, csa,
+                      a_pack);
+          gemm_macro_kernel(kern, mc, nc, kc, alpha, a_pack, b_pack, beta_pc,
+                            c + (ptrdiff_t)ic * rsc + (ptrdiff_t)jc * csc,
+                            rsc, csc, ep_pc, ic, jc);
+        }
+      }
+    }
+  }
+
+  return ERR_OK;
+}
+
+util_error_t gemm_strided_rc(size_t m, size_t n, size_t k, double alpha,
+                             const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                             const double* b, ptrdiff_t rsb, ptrdiff_t csb,
+                             double beta, double* c, ptrdiff_t rsc,
+                             ptrdiff_t csc) {
+  return gemm_run(m, n, k, alpha, a, rsa, csa, b, rsb, csb, NULL, beta, c, rsc,
+                  csc, NULL);
+}
+
+util_error_t gemm_strided_ep_rc(size_t m, size_t n, size_t k, double alpha,
+                                const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                                const double* b, ptrdiff_t rsb, ptrdiff_t csb,
+                                double beta, double* c, ptrdiff_t rsc,
+                                ptrdiff_t csc, const mat_epilogue_t* ep) {
+  return gemm_run(m, n, k, alpha, a, rsa, csa, b, rsb, csb, NULL, beta, c, rsc,
+                  csc, ep);
+}
+
+/* ============================================================ */
+/*                        Batched Products                      */
+/* ============================================================ */
+
+bool gemm_batch_across(size_t count, size_t m, size_t n, size_t k) {
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_in_parallel() ? 1 : omp_get_max_threads();
+#endif
+
+  if (count < 2 || nthreads < 2) {
+    return false;
+  }
+
+  // Small products are not split at all, and a batch with at least one
+  // product per thread keeps every core busy without splitting them
+  const bool small =
+      m <= GEMM_SMALL_MAX && n <= GEMM_SMALL_MAX && k <= GEMM_SMALL_MAX;
+  return small || count >= (size_t)nthreads;
+}
+
+util_error_t gemm_strided_batched_rc(
+    size_t count, size_t m, size_t n, size_t k, double alpha, const double* a,
+    ptrdiff_t rsa, ptrdiff_t csa, ptrdiff_t stride_a, const double* b,
+    ptrdiff_t rsb, ptrdiff_t csb, ptrdiff_t stride_b, double beta, double* c,
+    ptrdiff_t rsc, ptrdiff_t csc, ptrdiff_t stride_c) {
+  util_error_t status = ERR_OK;
+
+  const bool across = gemm_batch_across(count, m, n, k);
+  if (across) {
+    gemm_note_team();
+  }
+
+  #pragma omp parallel for schedule(static) if (across)
+  for (size_t t = 0; t < count; ++t) {
+    util_error_t rc = gemm_strided_rc(
+        m, n, k, alpha, a + (ptrdiff_t)t * stride_a, rsa, csa,
+        b + (ptrdiff_t)t * stride_b, rsb, csb, beta,
+        c + (ptrdiff_t)t * stride_c, rsc, csc);
+
+    if (rc != ERR_OK) {
+      #pragma omp atomic write
+      status = rc;
+    }
+  }
+
+  return status;
+}
+
+/* ============================================================ */
+/*                       Pre-packed Operands                    */
+/* ============================================================ */
+
+util_error_t gemm_pack_rc(size_t k, size_t n, const double* b, ptrdiff_t rsb,
+                          ptrdiff_t csb, gemm_packed_t** out) {
+  if (b == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (k == 0 || n == 0) {
+    return ERR_RANGE;
+  }
+
+  const simd_kernels_t* kern = simd_kernels();
+  const size_t nr_tile = kern->gemm_nr;
+  const size_t block_cols = gemm_round_up(GEMM_NC, nr_tile);
+  const size_t blocks = (n + GEMM_NC - 1) / GEMM_NC;
+  const size_t last_cols = gemm_round_up(n - (blocks - 1) * GEMM_NC, nr_tile);
+  const size_t cols = (blocks - 1) * block_cols + last_cols;
+
+  if (cols > SIZE_MAX / sizeof(double) / k) {
+    return ERR_RANGE;
+  }
+
+  gemm_packed_t* bp = (gemm_packed_t*)malloc(sizeof(gemm_packed_t));
+  if (bp == NULL) {
+    return ERR_ALLOC;
+  }
+
+  bp->k = k;
+  bp->n = n;
+  bp->kern = kern;
+  bp->bytes = get_aligned_size(k * cols);
+  bp->backend = alloc_backend();
+  bp->data = (double*)bp->backend->alloc(bp->backend->ctx, bp->bytes);
+  if (bp->data == NULL) {
+    free(bp);
+    return ERR_ALLOC;
+  }
+
+  for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+    const size_t nc = gemm_min(GEMM_NC, n - jc);
+
+    for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+      const size_t kc = gemm_min(GEMM_KC, k - pc);
+      const double* b_panel = b + (ptrdiff_t)pc * rsb + (ptrdiff_t)jc * csb;
+      double* panel = (double*)gemm_packed_panel(bp, jc, pc, nc);
+
+      #pragma omp parallel for schedule(static)
+      for (size_t jr = 0; jr < nc; jr += nr_tile) {
+        gemm_pack_b(kc, gemm_min(nr_tile, nc - jr), nr_tile,
+                    b_panel + (ptrdiff_t)jr * csb, rsb, csb, panel + jr * kc);
+      }
+    }
+  }
+
+  *out = bp;
+  return ERR_OK;
+}
+
+void gemm_packed_free_rc(gemm_packed_t* bp) {
+  if (!bp) {
+    return;
+  }
+
+  bp->backend->free(bp->backend->ctx, bp->data, bp->bytes);
+  free(bp);
+}
+
+util_error_t gemm_packed_rc(size_t m, size_t n, size_t k, double alpha,
+                            const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                            const gemm_packed_t* b, double beta, double* c,
+                            ptrdiff_t rsc, ptrdiff_t csc) {
+  if (b == NULL) {
+    return ERR_NULL;
+  }
+
+  if (b->k != k || b->n != n) {
+    return ERR_DIM;
+  }
+
+  return gemm_run(m, n, k, alpha, a, rsa, csa, NULL, 0, 0, b, beta, c, rsc,
+                  csc, NULL);
+}
+
+/* Lower triangle of a diagonal tile: C = alpha * A * A^T + beta * C for the
+ * nb rows of A starting at a. Each strip of rows is split into the block left
+ * of the diagonal (a plain GEMM into C) and the small diagonal block, which is
+ * computed into a local buffer so the strict upper triangle is never written. */
+static util_error_t gemm_syrk_diag_tile(size_t nb, size_t k, double alpha,
+                                        const double* a, ptrdiff_t rsa,
+                                        ptrdiff_t csa, double beta, double* c,
+                                        ptrdiff_t rsc, ptrdiff_t csc) {
+  double buf[GEMM_SYRK_STRIP * GEMM_SYRK_STRIP];
+
+  for (size_t r = 0; r < nb; r += GEMM_SYRK_STRIP) {
+    const size_t rb = gemm_min(GEMM_SYRK_STRIP, nb - r);
+    const double* a_strip = a + (ptrdiff_t)r * rsa;
+    double* c_strip = c + (ptrdiff_t)r * rsc;
+
+    util_error_t rc;
+    if (r > 0) {
+      rc = gemm_strided_rc(rb, r, k, alpha, a_strip, rsa, csa, a, csa, rsa,
+                           beta, c_strip, rsc, csc);
+      if (rc != ERR_OK) {
+        return rc;
+      }
+    }
+
+    rc = gemm_strided_rc(rb, rb, k, 1.0, a_strip, rsa, csa, a_strip, csa, rsa,
+                         0.0, buf, GEMM_SYRK_STRIP, 1);
+    if (rc != ERR_OK) {
+      return rc;
+    }
+
+    for (size_t i = 0; i < rb; ++i) {
+      double* c_row = c_strip + (ptrdiff_t)i * rsc + (ptrdiff_t)r * csc;
+      const double* buf_row = &buf[i * GEMM_SYRK_STRIP];
+      for (size_t j = 0; j <= i; ++j) {
+        double* c_ij = &c_row[(ptrdiff_t)j * csc];
+        *c_ij = (beta == 0.0) ? alpha * buf_row[j]
+                              : alpha * buf_row[j] + beta * *c_ij;
+      }
+    }
+  }
+
+  return ERR_OK;
+}
+
+util_error_t gemm_syrk_lower_rc(size_t n, size_t k, double alpha,
+                                const double* a, ptrdiff_t rsa, ptrdiff_t csa,
+                                double beta, double* c, ptrdiff_t rsc,
+                                ptrdiff_t csc) {
+  if (n == 0) {
+    return ERR_OK;
+  }
+
+  const size_t tiles = (n + GEMM_SYRK_TILE - 1) / GEMM_SYRK_TILE;
+  const size_t count = tiles * (tiles + 1) / 2;
+  util_error_t status = ERR_OK;
+
+  if (count > 1) {
+    gemm_note_team();
+  }
+
+  // Tiles of the lower triangle are enumerated row by row: t -> (bi, bj) with
+  // bj <= bi. Every tile is an independent GEMM run on a single thread.
+  #pragma omp parallel for schedule(static) if (count > 1)
+  for (size_t t = 0; t < count; ++t) {
+    size_t bi = 0;
+    while ((bi + 1) * (bi + 2) / 2 <= t) {
+      ++bi;
+    }
+    const size_t bj = t - bi * (bi + 1) / 2;
+
+    const size_t i0 = bi * GEMM_SYRK_TILE;
+    const size_t j0 = bj * GEMM_SYRK_TILE;
+    const size_t mb = gemm_min(GEMM_SYRK_TILE, n - i0);
+    const size_t nb = gemm_min(GEMM_SYRK_TILE, n - j0);
+    const double* a_i = a + (ptrdiff_t)i0 * rsa;
+    double* c_ij = c + (ptrdiff_t)i0 * rsc + (ptrdiff_t)j0 * csc;
+
+    util_error_t rc;
+    if (bi == bj) {
+      rc = gemm_syrk_diag_tile(mb, k, alpha, a_i, rsa, csa, beta, c_ij, rsc,
+                               csc);
+    } else {
+      rc = gemm_strided_rc(mb, nb, k, alpha, a_i, rsa, csa,
+                           a + (ptrdiff_t)j0 * rsa, csa, rsa, beta, c_ij, rsc,
+                           csc);
+    }
+
+    if (rc != ERR_OK) {
+      #pragma omp atomic write
+      status = rc;
+    }
+  }
+
+  return status;
+}
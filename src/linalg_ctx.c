@@ -0,0 +1,292 @@
+// sched_setaffinity and the CPU_* macros are hidden by -std=c11 otherwise
+#define _GNU_SOURCE
+
+#include "linalg_ctx.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "config.h"
+
+#ifdef __linux__
+#include <sched.h>
+#define LINALG_CTX_HAVE_AFFINITY
+#endif
+
+struct linalg_ctx_t {
+  size_t threads;  // 0: keep the thread's own count
+  linalg_pin_t pin;
+  size_t cpu_first;
+  size_t cpu_count;
+  bool has_threshold[PAR_KERNEL_COUNT];
+  size_t thresholds[PAR_KERNEL_COUNT];
+  void* scratch;
+  size_t scratch_bytes;
+
+  // Identifies the team size and CPU range; renewed whenever either changes
+  uint64_t pin_id;
+
+  // State of the thread the context is installed on, restored on uninstall
+  int saved_threads;
+#ifdef LINALG_CTX_HAVE_AFFINITY
+  bool saved_mask_valid;
+  cpu_set_t saved_mask;
+#endif
+};
+
+static _Thread_local linalg_ctx_t* ctx_current;
+
+// pin_id of the context that last pinned the calling thread's OpenMP team, or
+// 0 if none did. Ids are never reused, so neither a context freed and
+// reallocated at the same address nor a changed setting matches a stale one.
+static _Thread_local uint64_t ctx_team_pin_id;
+
+static uint64_t ctx_last_pin_id;
+
+/* internal helper: a pin_id no context has had before */
+static uint64_t ctx_next_pin_id(void) {
+  uint64_t id;
+  #pragma omp atomic capture
+  id = ++ctx_last_pin_id;
+  return id;
+}
+
+/* ============================================================ */
+/*                      Lifecycle Management                    */
+/* ============================================================ */
+
+util_error_t linalg_ctx_create_rc(linalg_ctx_t** out) {
+  if (out == NULL) {
+    return ERR_NULL;
+  }
+
+  linalg_ctx_t* ctx = (linalg_ctx_t*)calloc(1, sizeof(*ctx));
+  if (ctx == NULL) {
+    return ERR_ALLOC;
+  }
+
+  ctx->pin = LINALG_PIN_NONE;
+  ctx->pin_id = ctx_next_pin_id();
+  *out = ctx;
+
+  return ERR_OK;
+}
+
+void linalg_ctx_free_rc(linalg_ctx_t* ctx) {
+  if (ctx == NULL) {
+    return;
+  }
+
+  free(ctx->scratch);
+  free(ctx);
+}
+
+/* ============================================================ */
+/*                           Settings                           */
+/* ============================================================ */
+
+util_error_t linalg_ctx_set_threads_rc(linalg_ctx_t* ctx, size_t threads) {
+  if (ctx == NULL) {
+    return ERR_NULL;
+  }
+
+  if (threads > INT_MAX) {
+    return ERR_RANGE;
+  }
+
+  ctx->threads = threads;
+  ctx->pin_id = ctx_next_pin_id();  // the team size may change
+
+  return ERR_OK;
+}
+
+util_error_t linalg_ctx_set_pinning_rc(linalg_ctx_t* ctx, linalg_pin_t pin,
+                                       size_t first, size_t count) {
+  if (ctx == NULL) {
+    return ERR_NULL;
+  }
+
+  if (pin != LINALG_PIN_NONE && pin != LINALG_PIN_CORES) {
+    return ERR_INVALID_ARG;
+  }
+
+  if (pin == LINALG_PIN_CORES) {
+    if (count == 0 || first > SIZE_MAX - count) {
+      return ERR_RANGE;
+    }
+#ifdef LINALG_CTX_HAVE_AFFINITY
+    if (first + count > CPU_SETSIZE) {
+      return ERR_RANGE;
+    }
+#endif
+  }
+
+  ctx->pin = pin;
+  ctx->cpu_first = first;
+  ctx->cpu_count = count;
+  ctx->pin_id = ctx_next_pin_id();
+
+  return ERR_OK;
+}
+
+util_error_t linalg_ctx_set_threshold_rc(linalg_ctx_t* ctx, par_kernel_t kind,
+                                         size_t elements) {
+  if (ctx == NULL) {
+    return ERR_NULL;
+  }
+
+  if ((unsigned)kind >= PAR_KERNEL_COUNT) {
+    return ERR_INVALID_ARG;
+  }
+
+  ctx->has_threshold[kind] = true;
+  ctx->thresholds[kind] = elements;
+
+  return ERR_OK;
+}
+
+util_error_t linalg_ctx_reserve_scratch_rc(linalg_ctx_t* ctx, size_t bytes) {
+  if (ctx == NULL) {
+    return ERR_NULL;
+  }
+
+  if (bytes <= ctx->scratch_bytes) {
+    return ERR_OK;
+  }
+
+  if (bytes > SIZE_MAX - CACHE_LINE_SIZE) {
+    return ERR_RANGE;
+  }
+
+  const size_t rounded =
+      (bytes + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+  void* scratch = aligned_alloc(CACHE_LINE_SIZE, rounded);
+  if (scratch == NULL) {
+    return ERR_ALLOC;
+  }
+
+  free(ctx->scratch);
+  ctx->scratch = scratch;
+  ctx->scratch_bytes = rounded;
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                       Current Context                        */
+/* ============================================================ */
+
+#ifdef LINALG_CTX_HAVE_AFFINITY
+/* internal helper: pin the calling thread to one CPU */
+static void ctx_pin_self(size_t cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  sched_setaffinity(0, sizeof(set), &set);
+}
+#endif
+
+/* internal helper: apply the settings of 'ctx' to the calling thread */
+static void ctx_enter(linalg_ctx_t* ctx) {
+#ifdef _OPENMP
+  ctx->saved_threads = omp_get_max_threads();
+  if (ctx->threads > 0) {
+    omp_set_num_threads((int)ctx->threads);
+  }
+#endif
+
+#ifdef LINALG_CTX_HAVE_AFFINITY
+  ctx->saved_mask_valid = false;
+  if (ctx->pin != LINALG_PIN_CORES) {
+    return;
+  }
+
+  ctx->saved_mask_valid =
+      sched_getaffinity(0, sizeof(ctx->saved_mask), &ctx->saved_mask) == 0;
+
+  // The threads of a team are reused by later regions of the same thread, so
+  // the team keeps its pinning until another context re-pins it; the calling
+  // thread itself is unpinned on every uninstall
+  if (ctx_team_pin_id == ctx->pin_id) {
+    ctx_pin_self(ctx->cpu_first);
+    return;
+  }
+
+  const size_t first = ctx->cpu_first;
+  const size_t count = ctx->cpu_count;
+  #pragma omp parallel
+  {
+    size_t tid = 0;
+#ifdef _OPENMP
+    tid = (size_t)omp_get_thread_num();
+#endif
+    ctx_pin_self(first + tid % count);
+  }
+  ctx_team_pin_id = ctx->pin_id;
+#endif
+}
+
+/* internal helper: restore what ctx_enter changed on the calling thread */
+static void ctx_leave(linalg_ctx_t* ctx) {
+#ifdef _OPENMP
+  if (ctx->threads > 0) {
+    omp_set_num_threads(ctx->saved_threads);
+  }
+#endif
+
+#ifdef LINALG_CTX_HAVE_AFFINITY
+  if (ctx->saved_mask_valid) {
+    sched_setaffinity(0, sizeof(ctx->saved_mask), &ctx->saved_mask);
+    ctx->saved_mask_valid = false;
+  }
+#else
+  (void)ctx;
+#endif
+}
+
+linalg_ctx_t* linalg_ctx_set_current(linalg_ctx_t* ctx) {
+  linalg_ctx_t* prev = ctx_current;
+  if (ctx == prev) {
+    return prev;
+  }
+
+  if (prev != NULL) {
+    ctx_leave(prev);
+  }
+  if (ctx != NULL) {
+    ctx_enter(ctx);
+  }
+  ctx_current = ctx;
+
+  return prev;
+}
+
+linalg_ctx_t* linalg_ctx_current(void) { return ctx_current; }
+
+/* ============================================================ */
+/*                     Kernel Hooks (internal)                  */
+/* ============================================================ */
+
+bool linalg_ctx_threshold(par_kernel_t kind, size_t* out) {
+  const linalg_ctx_t* ctx = ctx_current;
+  if (ctx == NULL || !ctx->has_threshold[kind]) {
+    return false;
+  }
+
+  *out = ctx->thresholds[kind];
+  return true;
+}
+
+void* linalg_ctx_scratch(size_t bytes) {
+  const linalg_ctx_t* ctx = ctx_current;
+  if (ctx == NULL || bytes > ctx->scratch_bytes) {
+    return NULL;
+  }
+
+  return ctx->scratch;
+}
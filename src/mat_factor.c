@@ -0,0 +1,331 @@
+#include "mat_factor.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "decomp.h"
+#include "mat_rc.h"
+
+struct mat_factor_t {
+  mat_factor_kind_t kind;
+  mat_t* factors;  // LU: U on/above and unit L below the diagonal; Cholesky: L
+  size_t* piv;     // LU only
+  bool singular;
+};
+
+/* internal helper: allocate a handle holding a copy of a square matrix */
+static util_error_t mat_factor_alloc(const mat_t* restrict a,
+                                     mat_factor_kind_t kind,
+                                     mat_factor_t** restrict out) {
+  if (a->rows != a->cols) {
+    return ERR_DIM;
+  }
+
+  mat_factor_t* f = (mat_factor_t*)malloc(sizeof(mat_factor_t));
+  if (f == NULL) {
+    return ERR_ALLOC;
+  }
+
+  f->kind = kind;
+  f->factors = NULL;
+  f->piv = NULL;
+  f->singular = false;
+
+  // The handle outlives any per-request arena, so its factors stay off it
+  arena_t* arena = arena_set_current(NULL);
+  util_error_t rc = mat_alloc_rc(&f->factors, a->rows, a->cols);
+  arena_set_current(arena);
+  if (rc != ERR_OK) {
+    free(f);
+    return rc;
+  }
+
+  if (kind == MAT_FACTOR_LU) {
+    f->piv = (size_t*)malloc(a->rows * sizeof(size_t));
+    if (f->piv == NULL) {
+      mat_factor_free_rc(f);
+      return ERR_ALLOC;
+    }
+  }
+
+  mat_copy_rc(a, f->factors);
+
+  *out = f;
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                      Lifecycle Management                    */
+/* ============================================================ */
+
+util_error_t mat_factor_lu_rc(const mat_t* restrict a,
+                              mat_factor_t** restrict out) {
+  if (a == NULL || a->data == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  mat_factor_t* f = NULL;
+  util_error_t rc = mat_factor_alloc(a, MAT_FACTOR_LU, &f);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  const size_t n = a->rows;
+
+  rc = decomp_lu_rc(f->factors->data, n, n, f->piv, &f->singular);
+  if (rc != ERR_OK) {
+    mat_factor_free_rc(f);
+    return rc;
+  }
+
+  *out = f;
+  return ERR_OK;
+}
+
+util_error_t mat_factor_cholesky_rc(const mat_t* restrict a,
+                                    mat_factor_t** restrict out) {
+  if (a == NULL || a->data == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  mat_factor_t* f = NULL;
+  util_error_t rc = mat_factor_alloc(a, MAT_FACTOR_CHOLESKY, &f);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  const size_t n = a->rows;
+
+  rc = decomp_cholesky_rc(f->factors->data, n, n);
+  if (rc != ERR_OK) {
+    mat_factor_free_rc(f);
+    return rc;
+  }
+
+  *out = f;
+  return ERR_OK;
+}
+
+void mat_factor_free_rc(mat_factor_t* f) {
+  if (f == NULL) {
+    return;
+  }
+
+  mat_free_rc(f->factors);
+  free(f->piv);
+  free(f);
+}
+
+/* ============================================================ */
+/*                          Inspection                          */
+/* ============================================================ */
+
+util_error_t mat_factor_kind_rc(const mat_factor_t* restrict f,
+                                mat_factor_kind_t* restrict out) {
+  if (f == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  *out = f->kind;
+  return ERR_OK;
+}
+
+util_error_t mat_factor_size_rc(const mat_factor_t* restrict f,
+                                size_t* restrict out) {
+  if (f == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  *out = f->factors->rows;
+  return ERR_OK;
+}
+
+util_error_t mat_factor_logdet_rc(const mat_factor_t* restrict f,
+                                  double* restrict sign, double* restrict out) {
+  if (f == NULL || sign == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  const mat_t* m = f->factors;
+
+  if (f->singular) {
+    *sign = 0.0;
+    *out = -INFINITY;
+    return ERR_OK;
+  }
+
+  double s = 1.0;
+  double logabs = 0.0;
+
+  if (f->kind == MAT_FACTOR_CHOLESKY) {
+    // det(A) = prod(l_ii)^2, and every l_ii is positive
+    for (size_t i = 0; i < m->rows; ++i) {
+      logabs += log(MAT_AT(m, i, i));
+    }
+    logabs *= 2.0;
+  } else {
+    for (size_t i = 0; i < m->rows; ++i) {
+      double u_ii = MAT_AT(m, i, i);
+      if (u_ii < 0.0) {
+        s = -s;
+      }
+      if (f->piv[i] != i) {
+        s = -s;
+      }
+      logabs += log(fabs(u_ii));
+    }
+  }
+
+  *sign = s;
+  *out = logabs;
+  return ERR_OK;
+}
+
+util_error_t mat_factor_det_rc(const mat_factor_t* restrict f,
+                               double* restrict out) {
+  if (f == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  const mat_t* m = f->factors;
+
+  if (f->singular) {
+    *out = 0.0;
+    return ERR_OK;
+  }
+
+  double det = 1.0;
+
+  for (size_t i = 0; i < m->rows; ++i) {
+    double d = MAT_AT(m, i, i);
+    if (f->kind == MAT_FACTOR_CHOLESKY) {
+      det *= d * d;
+    } else {
+      det *= d;
+      if (f->piv[i] != i) {
+        det = -det;
+      }
+    }
+  }
+
+  *out = det;
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                            Solves                            */
+/* ============================================================ */
+
+/* internal helper: X := A^{-1} X in place for a row-major n x nrhs block */
+static util_error_t mat_factor_solve_block(const mat_factor_t* restrict f,
+                                           size_t nrhs, double* restrict x) {
+  const mat_t* m = f->factors;
+  const size_t n = m->rows;
+  const ptrdiff_t ld = (ptrdiff_t)n;
+
+  util_error_t rc;
+
+  if (f->kind == MAT_FACTOR_CHOLESKY) {
+    // L * Y = B, then L^T * X = Y with L^T addressed by swapped strides
+    rc = decomp_trsm_lower_rc(n, nrhs, m->data, ld, 1, false, x, nrhs);
+    if (rc != ERR_OK) {
+      return rc;
+    }
+    return decomp_trsm_upper_rc(n, nrhs, m->data, 1, ld, false, x, nrhs);
+  }
+
+  // L * U * X = P * B
+  decomp_lu_permute(n, nrhs, f->piv, x, nrhs);
+  rc = decomp_trsm_lower_rc(n, nrhs, m->data, ld, 1, true, x, nrhs);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+  return decomp_trsm_upper_rc(n, nrhs, m->data, ld, 1, false, x, nrhs);
+}
+
+util_error_t mat_factor_solve_vec_rc(const mat_factor_t* restrict f,
+                                     const vec_t* restrict b,
+                                     vec_t* restrict out) {
+  if (f == NULL || b == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (b->data == NULL || out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  const mat_t* m = f->factors;
+  const size_t n = m->rows;
+
+  if (b->n != n || out->n != n) {
+    return ERR_DIM;
+  }
+
+  if (f->singular) {
+    return ERR_DIV_ZERO;
+  }
+
+  memcpy(out->data, b->data, n * sizeof(double));
+
+  if (f->kind == MAT_FACTOR_CHOLESKY) {
+    decomp_cholesky_solve_vec(n, m->data, n, out->data);
+  } else {
+    decomp_lu_solve_vec(n, m->data, n, f->piv, out->data);
+  }
+
+  return ERR_OK;
+}
+
+util_error_t mat_factor_solve_mat_rc(const mat_factor_t* restrict f,
+                                     const mat_t* restrict b,
+                                     mat_t* restrict out) {
+  if (f == NULL || b == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (b->data == NULL || out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  const size_t n = f->factors->rows;
+
+  if (b->rows != n || out->rows != n || out->cols != b->cols) {
+    return ERR_DIM;
+  }
+
+  if (f->singular) {
+    return ERR_DIV_ZERO;
+  }
+
+  mat_copy_rc(b, out);
+
+  return mat_factor_solve_block(f, out->cols, out->data);
+}
+
+util_error_t mat_factor_inverse_rc(const mat_factor_t* restrict f,
+                                   mat_t* restrict out) {
+  if (f == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  const size_t n = f->factors->rows;
+
+  if (out->rows != n || out->cols != n) {
+    return ERR_DIM;
+  }
+
+  if (f->singular) {
+    return ERR_DIV_ZERO;
+  }
+
+  mat_identity_rc(out);
+
+  return mat_factor_solve_block(f, n, out->data);
+}
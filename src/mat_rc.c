@@ -5,7 +5,131 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "alloc.h"
+#include "arena.h"
 #include "config.h"
+#include "decomp.h"
+#include "eigen.h"
+#include "gemm.h"
+#include "mat_factor.h"
+#include "parallel.h"
+#include "pool.h"
+#include "simd.h"
+
+/* internal helper: validate the shape of a new matrix */
+static util_error_t mat_check_shape(size_t rows, size_t cols) {
+  if (rows == 0 || cols == 0) {
+    return ERR_RANGE;
+  }
+
+  if (rows > MATRIX_MAX_ROWS || cols > MATRIX_MAX_COLUMNS) {
+    return ERR_RANGE;
+  }
+
+  if (rows > SIZE_MAX / cols || rows * cols > MATRIX_MAX_ELEMENTS) {
+    return ERR_RANGE;
+  }
+
+  return ERR_OK;
+}
+
+// Bytes reserved for the header in front of inline data, keeping it aligned
+#define MAT_HEADER_BYTES \
+  ((sizeof(mat_t) + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1))
+
+/* internal helper: header followed by 'inline_bytes' of data storage in one
+ * block, taken from the current arena if any */
+static mat_t* mat_header_alloc(size_t inline_bytes) {
+  arena_t* arena = arena_current();
+  const size_t bytes = MAT_HEADER_BYTES + inline_bytes;
+  mat_t* m;
+  if (arena != NULL) {
+    m = (mat_t*)arena_alloc(arena, bytes);
+  } else {
+    const size_t rounded =
+        (bytes + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    m = (mat_t*)aligned_alloc(CACHE_LINE_SIZE, rounded);
+  }
+  if (m != NULL) {
+    m->in_arena = (arena != NULL);
+  }
+  return m;
+}
+
+static inline double* mat_inline_data(const mat_t* m) {
+  return (double*)((char*)m + MAT_HEADER_BYTES);
+}
+
+static inline bool mat_is_inline(const mat_t* m) {
+  return m->data == mat_inline_data(m);
+}
+
+/* internal helper: release a header allocated by mat_header_alloc */
+static void mat_header_free(mat_t* m) {
+  if (!m->in_arena) {
+    free(m);
+  }
+}
+
+/* internal helper: separate buffer of 'elements' doubles from the installed
+ * allocator backend, recycled through the calling thread's pool when it is
+ * enabled; *backend receives the backend that must release it */
+static double* mat_heap_data(size_t elements,
+                             const alloc_backend_t** backend) {
+  const alloc_backend_t* b = alloc_backend();
+  double* data = (double*)pool_acquire(elements * sizeof(double), b);
+  if (data == NULL) {
+    data = (double*)b->alloc(b->ctx, get_aligned_size(elements));
+  }
+  *backend = b;
+  return data;
+}
+
+/* internal helper: release a buffer from mat_heap_data */
+static void mat_heap_free(double* data, size_t elements,
+                          const alloc_backend_t* backend) {
+  if (!pool_release(data, elements * sizeof(double), backend)) {
+    backend->free(backend->ctx, data, get_aligned_size(elements));
+  }
+}
+
+/* internal helper: allocate 'elements' doubles, from the current arena if
+ * any; *backend is NULL for arena memory, otherwise the backend that must
+ * release the buffer with the matrix */
+static double* mat_data_alloc(size_t elements,
+                              const alloc_backend_t** backend) {
+  arena_t* arena = arena_current();
+  if (arena != NULL) {
+    *backend = NULL;
+    return (double*)arena_alloc(arena, get_aligned_size(elements));
+  }
+  return mat_heap_data(elements, backend);
+}
+
+/* internal helper: move inline data into a buffer of its own, so that the
+ * data pointer can be handed to another header */
+static util_error_t mat_detach(mat_t* m) {
+  if (!mat_is_inline(m)) {
+    return ERR_OK;
+  }
+
+  const size_t elements = m->rows * m->cols;
+  const alloc_backend_t* backend;
+  double* data = mat_data_alloc(elements, &backend);
+  if (data == NULL) {
+    return ERR_ALLOC;
+  }
+
+  memcpy(data, m->data, elements * sizeof(double));
+  m->data = data;
+  m->owns_data = (backend != NULL);
+  m->backend = backend;
+  return ERR_OK;
+}
 
 /* internal helper: validate same shape */
 static inline int mat_same_shape(const mat_t* restrict a,
@@ -22,25 +146,19 @@ util_error_t mat_alloc_rc(mat_t** restrict out, size_t rows, size_t cols) {
     return ERR_NULL;
   }
 
-  if (rows == 0 || cols == 0) {
-    return ERR_RANGE;
-  }
-
-  if (rows > MATRIX_MAX_ROWS || cols > MATRIX_MAX_COLUMNS) {
-    return ERR_RANGE;
-  }
-
-  if (rows > SIZE_MAX / cols) {
-    return ERR_RANGE;
+  util_error_t rc = mat_check_shape(rows, cols);
+  if (rc != ERR_OK) {
+    return rc;
   }
 
   size_t elements = rows * cols;
 
-  if (elements > MATRIX_MAX_ELEMENTS) {
-    return ERR_RANGE;
-  }
+  // Header and data share one block unless the data is large
+  const size_t bytes = get_aligned_size(elements);
+  const bool co_alloc =
+      (bytes <= INLINE_DATA_MAX_BYTES || arena_current() != NULL);
 
-  mat_t* m = (mat_t*)malloc(sizeof(mat_t));
+  mat_t* m = mat_header_alloc(co_alloc ? bytes : 0);
   if (m == NULL) {
     return ERR_ALLOC;
   }
@@ -48,12 +166,17 @@ util_error_t mat_alloc_rc(mat_t** restrict out, size_t rows, size_t cols) {
   m->rows = rows;
   m->cols = cols;
 
-  size_t aligned_bytes = get_aligned_size(elements);
-
-  m->data = (double*)aligned_alloc(ALIGNMENT, aligned_bytes);
-  if (m->data == NULL) {
-    free(m);
-    return ERR_ALLOC;
+  if (co_alloc) {
+    m->data = mat_inline_data(m);
+    m->owns_data = false;
+    m->backend = NULL;
+  } else {
+    m->data = mat_heap_data(elements, &m->backend);
+    m->owns_data = true;
+    if (m->data == NULL) {
+      mat_header_free(m);
+      return ERR_ALLOC;
+    }
   }
 
   *out = m;
@@ -81,13 +204,54 @@ util_error_t mat_from_array_rc(const double* restrict data,
   return ERR_OK;
 }
 
+util_error_t mat_wrap_rc(double* data, mat_t** restrict out, size_t rows,
+                         size_t cols, util_ownership_t own) {
+  if (out == NULL || data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (own != OWN_BORROW && own != OWN_ADOPT) {
+    return ERR_INVALID_ARG;
+  }
+
+  util_error_t rc = mat_check_shape(rows, cols);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  // A misaligned buffer is copied so the ALIGNMENT guarantee on 'data' holds
+  if ((uintptr_t)data % ALIGNMENT != 0) {
+    rc = mat_from_array_rc(data, out, rows, cols);
+    if (rc == ERR_OK && own == OWN_ADOPT) {
+      free(data);
+    }
+    return rc;
+  }
+
+  mat_t* m = mat_header_alloc(0);
+  if (m == NULL) {
+    return ERR_ALLOC;
+  }
+
+  m->rows = rows;
+  m->cols = cols;
+  m->data = data;
+  m->owns_data = (own == OWN_ADOPT);
+  m->backend = m->owns_data ? alloc_backend_default() : NULL;
+
+  *out = m;
+  return ERR_OK;
+}
+
 void mat_free_rc(mat_t* m) {
   if (!m) {
     return;
   }
 
-  free(m->data);
-  free(m);
+  if (m->owns_data) {
+    mat_heap_free(m->data, m->rows * m->cols, m->backend);
+  }
+  mat_header_free(m);
 }
 
 void mat_freep_rc(mat_t** restrict mp) {
@@ -95,8 +259,7 @@ void mat_freep_rc(mat_t** restrict mp) {
     return;
   }
 
-  free((*mp)->data);
-  free(*mp);
+  mat_free_rc(*mp);
   *mp = NULL;
 }
 
@@ -129,8 +292,8 @@ util_error_t mat_resize_rc(mat_t** restrict mp, size_t new_rows,
     return ERR_RANGE;
   }
 
-  size_t new_aligned_bytes = get_aligned_size(new_elements);
-  double* new_data = (double*)aligned_alloc(ALIGNMENT, new_aligned_bytes);
+  const alloc_backend_t* new_backend;
+  double* new_data = mat_data_alloc(new_elements, &new_backend);
   if (new_data == NULL) {
     return ERR_ALLOC;
   }
@@ -144,15 +307,20 @@ util_error_t mat_resize_rc(mat_t** restrict mp, size_t new_rows,
   const double* restrict src_base = m->data;
   double* restrict dst_base = new_data;
 
-  #pragma omp parallel for schedule(static)
+  #pragma omp parallel for schedule(static) \
+      if (copy_rows * copy_cols >= par_threshold(PAR_STREAM))
   for (size_t i = 0; i < copy_rows; ++i) {
     const double* src_row = src_base + (i * m->cols);
     double* dst_row = dst_base + (i * new_cols);
     memcpy(dst_row, src_row, row_copy_size);
   }
 
-  free(m->data);
+  if (m->owns_data) {
+    mat_heap_free(m->data, m->rows * m->cols, m->backend);
+  }
   m->data = new_data;
+  m->owns_data = (new_backend != NULL);
+  m->backend = new_backend;
   m->rows = new_rows;
   m->cols = new_cols;
 
@@ -411,9 +579,17 @@ util_error_t mat_add_rc(const mat_t* restrict a, const mat_t* restrict b,
   const double* restrict b_data = b->data;
   double* restrict out_data = out->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->add(n, a_data, b_data, out_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    out_data[i] = a_data[i] + b_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->add(len, a_data + i, b_data + i, out_data + i);
   }
 
   return ERR_OK;
@@ -437,9 +613,17 @@ util_error_t mat_add_inplace_rc(mat_t* restrict dest,
   double* restrict dest_data = dest->data;
   const double* restrict src_data = src->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->add(n, dest_data, src_data, dest_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    dest_data[i] += src_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->add(len, dest_data + i, src_data + i, dest_data + i);
   }
 
   return ERR_OK;
@@ -464,9 +648,17 @@ util_error_t mat_subtract_rc(const mat_t* restrict a, const mat_t* restrict b,
   const double* restrict b_data = b->data;
   double* restrict out_data = out->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->sub(n, a_data, b_data, out_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    out_data[i] = a_data[i] - b_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->sub(len, a_data + i, b_data + i, out_data + i);
   }
 
   return ERR_OK;
@@ -490,9 +682,17 @@ util_error_t mat_subtract_inplace_rc(mat_t* restrict dest,
   double* restrict dest_data = dest->data;
   const double* restrict src_data = src->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->sub(n, dest_data, src_data, dest_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    dest_data[i] -= src_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->sub(len, dest_data + i, src_data + i, dest_data + i);
   }
 
   return ERR_OK;
@@ -520,9 +720,17 @@ util_error_t mat_scale_rc(const mat_t* restrict a, mat_t* restrict out,
   const double* restrict a_data = a->data;
   double* restrict out_data = out->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->scale(n, scalar, a_data, out_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    out_data[i] = a_data[i] * scalar;
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->scale(len, scalar, a_data + i, out_data + i);
   }
 
   return ERR_OK;
@@ -540,9 +748,17 @@ util_error_t mat_scale_inplace_rc(mat_t* restrict dest, double scalar) {
   const size_t n = dest->rows * dest->cols;
   double* restrict dest_data = dest->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->scale(n, scalar, dest_data, dest_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    dest_data[i] *= scalar;
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->scale(len, scalar, dest_data + i, dest_data + i);
   }
 
   return ERR_OK;
@@ -567,6 +783,13 @@ util_error_t mat_hadamard_rc(const mat_t* restrict a, const mat_t* restrict b,
   const double* restrict b_data = b->data;
   double* restrict out_data = out->data;
 
+  if (n < par_threshold(PAR_STREAM)) {
+    for (size_t i = 0; i < n; ++i) {
+      out_data[i] = a_data[i] * b_data[i];
+    }
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < n; ++i) {
     out_data[i] = a_data[i] * b_data[i];
@@ -626,86 +849,75 @@ util_error_t mat_multiply_rc(const mat_t* restrict a, const mat_t* restrict b,
     return ERR_DIM;
   }
 
-  mat_t* b_t = NULL;
-  util_error_t rc = mat_alloc_rc(&b_t, b->cols, b->rows);
-  if (rc != ERR_OK) {
-    return rc;
-  }
-
-  mat_transpose_rc(b, b_t);
-
-  const size_t a_rows = a->rows;
   const size_t a_cols = a->cols;
   const size_t out_cols = out->cols;
 
-  const double* restrict a_data = a->data;
-  const double* restrict bt_data = b_t->data;
-  double* restrict out_data = out->data;
-
-  #pragma omp parallel for collapse(2) schedule(static)
-  for (size_t i = 0; i < a_rows; ++i) {
-    for (size_t j = 0; j < out_cols; ++j) {
-      double sum = 0.0;
-      const double* restrict row_a = &a_data[i * a_cols];
-      const double* restrict row_bt = &bt_data[j * a_cols];
-      #pragma omp simd reduction(+ : sum)
-      for (size_t k = 0; k < a_cols; ++k) {
-        sum += row_a[k] * row_bt[k];
-      }
-      out_data[i * out_cols + j] = sum;
-    }
-  }
-
-  mat_free_rc(b_t);
+  return gemm_strided_rc(a->rows, out_cols, a_cols, 1.0, a->data,
+                         (ptrdiff_t)a_cols, 1, b->data, (ptrdiff_t)out_cols, 1,
+                         0.0, out->data, (ptrdiff_t)out_cols, 1);
+}
 
-  return ERR_OK;
+util_error_t mat_gemm_rc(util_transpose_t trans_a, util_transpose_t trans_b,
+                         double alpha, const mat_t* a, const mat_t* b,
+                         double beta, mat_t* restrict c) {
+  return mat_gemm_ep_rc(trans_a, trans_b, alpha, a, b, beta, c, NULL);
 }
 
-util_error_t mat_vec_multiply_rc(const mat_t* restrict m,
-                                 const vec_t* restrict v, vec_t* restrict out) {
-  if (m == NULL || v == NULL || out == NULL) {
+util_error_t mat_gemm_ep_rc(util_transpose_t trans_a, util_transpose_t trans_b,
+                            double alpha, const mat_t* a, const mat_t* b,
+                            double beta, mat_t* restrict c,
+                            const mat_epilogue_t* ep) {
+  if (a == NULL || b == NULL || c == NULL) {
     return ERR_NULL;
   }
 
-  if (m->data == NULL || v->data == NULL || out->data == NULL) {
+  if (a->data == NULL || b->data == NULL || c->data == NULL) {
     return ERR_NULL;
   }
 
-  if (m->cols != v->n) {
-    return ERR_DIM;
+  if ((trans_a != TRANS_NONE && trans_a != TRANS_T) ||
+      (trans_b != TRANS_NONE && trans_b != TRANS_T)) {
+    return ERR_INVALID_ARG;
   }
 
-  if (out->n != m->rows) {
+  // op(X) is X read through swapped strides when transposed
+  const bool ta = (trans_a == TRANS_T);
+  const bool tb = (trans_b == TRANS_T);
+  const size_t m = ta ? a->cols : a->rows;
+  const size_t k = ta ? a->rows : a->cols;
+  const size_t kb = tb ? b->cols : b->rows;
+  const size_t n = tb ? b->rows : b->cols;
+
+  if (k != kb || c->rows != m || c->cols != n) {
     return ERR_DIM;
   }
 
-  const size_t rows = m->rows;
-  const size_t cols = m->cols;
+  const ptrdiff_t lda = (ptrdiff_t)a->cols;
+  const ptrdiff_t ldb = (ptrdiff_t)b->cols;
 
-  const double* restrict m_data = m->data;
-  const double* restrict v_data = v->data;
-  double* restrict out_data = out->data;
-  
-  #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < rows; ++i) {
-    double sum = 0.0;
-    const double* restrict row_m = &m_data[i * cols];
-    #pragma omp simd reduction(+ : sum)
-    for (size_t j = 0; j < cols; ++j) {
-      sum += row_m[j] * v_data[j];
-    }
-    out_data[i] = sum;
+  return gemm_strided_ep_rc(m, n, k, alpha, a->data, ta ? 1 : lda,
+                            ta ? lda : 1, b->data, tb ? 1 : ldb, tb ? ldb : 1,
+                            beta, c->data, (ptrdiff_t)n, 1, ep);
+}
+
+util_error_t mat_pack_rc(const mat_t* restrict b, mat_packed_t** restrict out) {
+  if (b == NULL || out == NULL) {
+    return ERR_NULL;
   }
 
-  return ERR_OK;
+  if (b->data == NULL) {
+    return ERR_NULL;
+  }
+
+  return gemm_pack_rc(b->rows, b->cols, b->data, (ptrdiff_t)b->cols, 1, out);
 }
 
-/* ============================================================ */
-/*                    Matrix transformations                    */
-/* ============================================================ */
+void mat_packed_free_rc(mat_packed_t* p) { gemm_packed_free_rc(p); }
 
-util_error_t mat_transpose_rc(const mat_t* restrict a, mat_t* restrict out) {
-  if (a == NULL || out == NULL) {
+util_error_t mat_multiply_packed_rc(const mat_t* restrict a,
+                                    const mat_packed_t* restrict b,
+                                    mat_t* restrict out) {
+  if (a == NULL || b == NULL || out == NULL) {
     return ERR_NULL;
   }
 
@@ -713,117 +925,1216 @@ util_error_t mat_transpose_rc(const mat_t* restrict a, mat_t* restrict out) {
     return ERR_NULL;
   }
 
-  if (a->rows != out->cols || a->cols != out->rows) {
+  if (out->rows != a->rows) {
     return ERR_DIM;
   }
 
-  const size_t rows = a->rows;
-  const size_t cols = a->cols;
-
-  const double* restrict a_data = a->data;
-  double* restrict out_data = out->data;
+  // The packed operand checks that it is a->cols x out->cols
+  const size_t out_cols = out->cols;
+  return gemm_packed_rc(a->rows, out_cols, a->cols, 1.0, a->data,
+                        (ptrdiff_t)a->cols, 1, b, 0.0, out->data,
+                        (ptrdiff_t)out_cols, 1);
+}
 
-  #pragma omp parallel for collapse(2) schedule(static)
-  for (size_t i = 0; i < rows; ++i) {
-    for (size_t j = 0; j < cols; ++j) {
-      out_data[j * rows + i] = a_data[i * cols + j];
-    }
+util_error_t mat_multiply_batched_rc(const mat_t* const* a,
+                                     const mat_t* const* b,
+                                     mat_t* const* out, size_t count) {
+  if (count == 0) {
+    return ERR_OK;
   }
 
-  return ERR_OK;
-}
-
-util_error_t mat_reshape_rc(mat_t* restrict m, size_t new_rows,
-                            size_t new_cols) {
-  if (m == NULL || m->data == NULL) {
+  if (a == NULL || b == NULL || out == NULL) {
     return ERR_NULL;
   }
 
-  size_t old_elements = m->rows * m->cols;
-  size_t new_elements = new_rows * new_cols;
+  size_t max_m = 0, max_n = 0, max_k = 0;
+  for (size_t t = 0; t < count; ++t) {
+    const mat_t* at = a[t];
+    const mat_t* bt = b[t];
+    const mat_t* ot = out[t];
+    if (at == NULL || bt == NULL || ot == NULL) {
+      return ERR_NULL;
+    }
 
-  if (old_elements != new_elements) {
-    return ERR_DIM;
-  }
+    if (at->data == NULL || bt->data == NULL || ot->data == NULL) {
+      return ERR_NULL;
+    }
 
-  m->rows = new_rows;
-  m->cols = new_cols;
+    if (at->cols != bt->rows || ot->rows != at->rows ||
+        ot->cols != bt->cols) {
+      return ERR_DIM;
+    }
 
-  return ERR_OK;
-}
+    max_m = (at->rows > max_m) ? at->rows : max_m;
+    max_n = (bt->cols > max_n) ? bt->cols : max_n;
+    max_k = (at->cols > max_k) ? at->cols : max_k;
+  }
 
-/* ============================================================ */
-/*              Properties, Comparison and Utility              */
-/* ============================================================ */
+  util_error_t status = ERR_OK;
 
-util_error_t mat_is_square_rc(const mat_t* restrict m, bool* restrict out) {
-  if (m == NULL || out == NULL) {
-    return ERR_NULL;
-  }
+  #pragma omp parallel for schedule(static) \
+      if (gemm_batch_across(count, max_m, max_n, max_k))
+  for (size_t t = 0; t < count; ++t) {
+    const size_t k = a[t]->cols;
+    const size_t n = out[t]->cols;
+    util_error_t rc = gemm_strided_rc(a[t]->rows, n, k, 1.0, a[t]->data,
+                                      (ptrdiff_t)k, 1, b[t]->data,
+                                      (ptrdiff_t)n, 1, 0.0, out[t]->data,
+                                      (ptrdiff_t)n, 1);
 
-  *out = (m->rows == m->cols);
+    if (rc != ERR_OK) {
+      #pragma omp atomic write
+      status = rc;
+    }
+  }
 
-  return ERR_OK;
+  return status;
 }
 
-util_error_t mat_is_equal_rc(const mat_t* restrict a, const mat_t* restrict b,
-                             double epsilon, bool* restrict out) {
-  if (a == NULL || b == NULL || out == NULL) {
-    return ERR_NULL;
+util_error_t mat_multiply_strided_batched_rc(size_t count, size_t m, size_t k,
+                                             size_t n,
+                                             const double* restrict a,
+                                             const double* restrict b,
+                                             double* restrict out) {
+  if (count == 0) {
+    return ERR_OK;
   }
 
-  if (a->data == NULL || b->data == NULL) {
+  if (a == NULL || b == NULL || out == NULL) {
     return ERR_NULL;
   }
 
-  if (!mat_same_shape(a, b)) {
-    *out = false;
-    return ERR_OK;
+  if (m == 0 || k == 0 || n == 0) {
+    return ERR_RANGE;
   }
 
-  const size_t n = a->rows * a->cols;
-  const double* restrict a_data = a->data;
-  const double* restrict b_data = b->data;
-
-  for (size_t i = 0; i < n; ++i) {
-    if (fabs(a_data[i] - b_data[i]) > epsilon) {
-      *out = false;
-      return ERR_OK;
-    }
+  // Every stride, and the offset of the last operand, must fit a ptrdiff_t
+  const size_t limit = (size_t)PTRDIFF_MAX / count;
+  if (m > limit / k || k > limit / n || m > limit / n) {
+    return ERR_RANGE;
   }
 
-  *out = true;
+  return gemm_strided_batched_rc(
+      count, m, n, k, 1.0, a, (ptrdiff_t)k, 1, (ptrdiff_t)(m * k), b,
+      (ptrdiff_t)n, 1, (ptrdiff_t)(k * n), 0.0, out, (ptrdiff_t)n, 1,
+      (ptrdiff_t)(m * n));
+}
 
-  return ERR_OK;
+util_error_t mat_vec_multiply_rc(const mat_t* restrict m,
+                                 const vec_t* restrict v, vec_t* restrict out) {
+  return mat_gemv_rc(TRANS_NONE, 1.0, m, v, 0.0, out);
 }
 
-util_error_t mat_sum_rc(const mat_t* restrict m, double* restrict out) {
-  if (m == NULL || m->data == NULL || out == NULL) {
-    return ERR_NULL;
+/* internal helper: y[r][i] = a_row * x[r] for r < k. The row is streamed from
+ * memory once; it is then re-read from cache by every group of four
+ * right-hand sides. */
+static inline void mat_vec_multi_row(const simd_kernels_t* kern, size_t cols,
+                                     const double* a_row,
+                                     const double* const* x, double* const* y,
+                                     size_t k, size_t i) {
+  size_t r = 0;
+  for (; r + 4 <= k; r += 4) {
+    double dots[4];
+    kern->dot4(cols, a_row, &x[r], dots);
+    for (size_t q = 0; q < 4; ++q) {
+      y[r + q][i] = dots[q];
+    }
+  }
+  for (; r < k; ++r) {
+    y[r][i] = kern->dot(cols, a_row, x[r]);
   }
+}
 
-  const size_t n = m->rows * m->cols;
-  const double* restrict m_data = m->data;
-  double total_sum = 0.0;
+/* internal helper: y[r] = a * x[r] for the rows x cols matrix a, r < k */
+static void mat_vec_multi(size_t rows, size_t cols, const double* a,
+                          const double* const* x, double* const* y, size_t k) {
+  const simd_kernels_t* kern = simd_kernels();
 
-  #pragma omp parallel for reduction(+ : total_sum) schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    total_sum += m_data[i];
+  if (rows * cols < par_threshold(PAR_REDUCE)) {
+    for (size_t i = 0; i < rows; ++i) {
+      mat_vec_multi_row(kern, cols, &a[i * cols], x, y, k, i);
+    }
+    return;
   }
 
-  *out = total_sum;
-  return ERR_OK;
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < rows; ++i) {
+    mat_vec_multi_row(kern, cols, &a[i * cols], x, y, k, i);
+  }
 }
 
-util_error_t mat_swap_rc(mat_t* restrict a, mat_t* restrict b) {
-  if (a == NULL || b == NULL) {
+util_error_t mat_vec_multiply_multi_rc(const mat_t* restrict m,
+                                       const vec_t* const* v,
+                                       vec_t* const* out, size_t k) {
+  if (m == NULL || m->data == NULL) {
     return ERR_NULL;
   }
 
-  if (a == b) {
+  if (k == 0) {
     return ERR_OK;
   }
 
+  if (v == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  for (size_t r = 0; r < k; ++r) {
+    if (v[r] == NULL || out[r] == NULL) {
+      return ERR_NULL;
+    }
+
+    if (v[r]->data == NULL || out[r]->data == NULL) {
+      return ERR_NULL;
+    }
+
+    if (v[r]->n != m->cols || out[r]->n != m->rows) {
+      return ERR_DIM;
+    }
+  }
+
+  const double** xs = (const double**)malloc(k * sizeof(*xs));
+  double** ys = (double**)malloc(k * sizeof(*ys));
+  if (xs == NULL || ys == NULL) {
+    free(xs);
+    free(ys);
+    return ERR_ALLOC;
+  }
+
+  for (size_t r = 0; r < k; ++r) {
+    xs[r] = v[r]->data;
+    ys[r] = out[r]->data;
+  }
+
+  mat_vec_multi(m->rows, m->cols, m->data, xs, ys, k);
+
+  free(xs);
+  free(ys);
+
+  return ERR_OK;
+}
+
+/* internal helper: y = alpha * acc + beta * y; y is not read if beta == 0 */
+static inline void mat_gemv_store(double* y, double alpha, double acc,
+                                  double beta) {
+  *y = (beta == 0.0) ? alpha * acc : alpha * acc + beta * *y;
+}
+
+/* internal helper: y = alpha * A^T x + beta * y on the calling thread, one
+ * axpy per row of A straight into y */
+static void mat_gemv_t_serial(size_t rows, size_t cols, double alpha,
+                              const double* restrict a,
+                              const double* restrict x, double beta,
+                              double* restrict y) {
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (beta == 0.0) {
+    memset(y, 0, cols * sizeof(double));
+  } else if (beta != 1.0) {
+    kern->scale(cols, beta, y, y);
+  }
+
+  for (size_t i = 0; i < rows; ++i) {
+    kern->axpy(cols, alpha * x[i], &a[i * cols], y);
+  }
+}
+
+/* internal helper: y = alpha * A^T x + beta * y across threads. Each thread
+ * streams a static block of rows into a partial vector of its own, then the
+ * partials are summed column by column into y. */
+static util_error_t mat_gemv_t_parallel(size_t rows, size_t cols, double alpha,
+                                        const double* restrict a,
+                                        const double* restrict x, double beta,
+                                        double* restrict y, int nthreads) {
+  // Partials start on their own cache lines so threads never share one
+  const size_t line = CACHE_LINE_SIZE / sizeof(double);
+  const size_t stride = (cols + line - 1) / line * line;
+  const size_t bytes = (size_t)nthreads * stride * sizeof(double);
+  double* partial = (double*)linalg_ctx_scratch(bytes);
+  double* owned = NULL;
+  if (partial == NULL) {
+    partial = owned = (double*)aligned_alloc(CACHE_LINE_SIZE, bytes);
+    if (partial == NULL) {
+      return ERR_ALLOC;
+    }
+  }
+
+  const simd_kernels_t* kern = simd_kernels();
+
+  #pragma omp parallel num_threads(nthreads)
+  {
+    int tid = 0;
+    int team = 1;
+#ifdef _OPENMP
+    tid = omp_get_thread_num();
+    team = omp_get_num_threads();
+#endif
+    double* restrict acc = partial + (size_t)tid * stride;
+    memset(acc, 0, cols * sizeof(double));
+
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < rows; ++i) {
+      kern->axpy(cols, x[i], &a[i * cols], acc);
+    }
+
+    #pragma omp for schedule(static)
+    for (size_t j = 0; j < cols; ++j) {
+      double sum = 0.0;
+      for (int t = 0; t < team; ++t) {
+        sum += partial[(size_t)t * stride + j];
+      }
+      mat_gemv_store(&y[j], alpha, sum, beta);
+    }
+  }
+
+  free(owned);
+
+  return ERR_OK;
+}
+
+util_error_t mat_gemv_rc(util_transpose_t trans, double alpha,
+                         const mat_t* restrict a, const vec_t* restrict x,
+                         double beta, vec_t* restrict y) {
+  if (a == NULL || x == NULL || y == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->data == NULL || x->data == NULL || y->data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (trans != TRANS_NONE && trans != TRANS_T) {
+    return ERR_INVALID_ARG;
+  }
+
+  const size_t rows = a->rows;
+  const size_t cols = a->cols;
+
+  // op(A) is rows x cols, or cols x rows when transposed
+  const size_t x_len = (trans == TRANS_T) ? rows : cols;
+  const size_t y_len = (trans == TRANS_T) ? cols : rows;
+  if (x->n != x_len || y->n != y_len) {
+    return ERR_DIM;
+  }
+
+  const double* restrict a_data = a->data;
+  const double* restrict x_data = x->data;
+  double* restrict y_data = y->data;
+
+  if (trans == TRANS_NONE) {
+    const simd_kernels_t* kern = simd_kernels();
+
+    if (rows * cols < par_threshold(PAR_REDUCE)) {
+      for (size_t i = 0; i < rows; ++i) {
+        const double acc = kern->dot(cols, &a_data[i * cols], x_data);
+        mat_gemv_store(&y_data[i], alpha, acc, beta);
+      }
+      return ERR_OK;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < rows; ++i) {
+      const double acc = kern->dot(cols, &a_data[i * cols], x_data);
+      mat_gemv_store(&y_data[i], alpha, acc, beta);
+    }
+
+    return ERR_OK;
+  }
+
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_in_parallel() ? 1 : omp_get_max_threads();
+#endif
+
+  // A single row has nothing to split; with partials it would only add a pass
+  if (nthreads < 2 || rows < 2 || rows * cols < par_threshold(PAR_REDUCE)) {
+    mat_gemv_t_serial(rows, cols, alpha, a_data, x_data, beta, y_data);
+    return ERR_OK;
+  }
+
+  if ((size_t)nthreads > rows) {
+    nthreads = (int)rows;
+  }
+
+  return mat_gemv_t_parallel(rows, cols, alpha, a_data, x_data, beta, y_data,
+                             nthreads);
+}
+
+util_error_t mat_multiply_ctx_rc(linalg_ctx_t* ctx, const mat_t* restrict a,
+                                 const mat_t* restrict b, mat_t* restrict out) {
+  if (ctx == NULL) {
+    return ERR_NULL;
+  }
+
+  util_error_t rc;
+  LINALG_CTX_CALL(ctx, rc, mat_multiply_rc(a, b, out));
+  return rc;
+}
+
+util_error_t mat_gemm_ctx_rc(linalg_ctx_t* ctx, util_transpose_t trans_a,
+                             util_transpose_t trans_b, double alpha,
+                             const mat_t* a, const mat_t* b, double beta,
+                             mat_t* restrict c) {
+  if (ctx == NULL) {
+    return ERR_NULL;
+  }
+
+  util_error_t rc;
+  LINALG_CTX_CALL(ctx, rc,
+                  mat_gemm_rc(trans_a, trans_b, alpha, a, b, beta, c));
+  return rc;
+}
+
+util_error_t mat_gemv_ctx_rc(linalg_ctx_t* ctx, util_transpose_t trans,
+                             double alpha, const mat_t* restrict a,
+                             const vec_t* restrict x, double beta,
+                             vec_t* restrict y) {
+  if (ctx == NULL) {
+    return ERR_NULL;
+  }
+
+  util_error_t rc;
+  LINALG_CTX_CALL(ctx, rc, mat_gemv_rc(trans, alpha, a, x, beta, y));
+  return rc;
+}
+
+/* ============================================================ */
+/*                    Matrix transformations                    */
+/* ============================================================ */
+
+/* internal helper: b[j * ldb + i] = a[i * lda + j] for a rows x cols block,
+ * in 4 x 4 tiles through the SIMD kernel */
+static void mat_transpose_block(const simd_kernels_t* kern, size_t rows,
+                                size_t cols, const double* restrict a,
+                                size_t lda, double* restrict b, size_t ldb) {
+  const size_t rows4 = rows & ~(size_t)3;
+  const size_t cols4 = cols & ~(size_t)3;
+
+  for (size_t i = 0; i < rows4; i += 4) {
+    for (size_t j = 0; j < cols4; j += 4) {
+      kern->transpose_4x4(a + i * lda + j, lda, b + j * ldb + i, ldb);
+    }
+    for (size_t ii = i; ii < i + 4; ++ii) {
+      for (size_t j = cols4; j < cols; ++j) {
+        b[j * ldb + ii] = a[ii * lda + j];
+      }
+    }
+  }
+
+  for (size_t i = rows4; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      b[j * ldb + i] = a[i * lda + j];
+    }
+  }
+}
+
+/* internal helper: in-place transpose of an n x n row-major matrix. Tiles on
+ * the diagonal swap across it; every other tile trades places with its mirror
+ * through a stack buffer. */
+static void mat_transpose_square(double* a, size_t n) {
+  const simd_kernels_t* kern = simd_kernels();
+  const size_t tiles = (n + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+  const size_t count = tiles * (tiles + 1) / 2;
+
+  // Tile pairs are enumerated row by row: t -> (bi, bj) with bj <= bi
+  #pragma omp parallel for schedule(static) \
+      if (n * n >= par_threshold(PAR_STREAM))
+  for (size_t t = 0; t < count; ++t) {
+    size_t bi = 0;
+    while ((bi + 1) * (bi + 2) / 2 <= t) {
+      ++bi;
+    }
+    const size_t bj = t - bi * (bi + 1) / 2;
+
+    const size_t i0 = bi * TRANSPOSE_TILE;
+    const size_t j0 = bj * TRANSPOSE_TILE;
+    const size_t mb = (n - i0 < TRANSPOSE_TILE) ? n - i0 : TRANSPOSE_TILE;
+    const size_t nb = (n - j0 < TRANSPOSE_TILE) ? n - j0 : TRANSPOSE_TILE;
+
+    if (bi == bj) {
+      for (size_t i = i0 + 1; i < i0 + mb; ++i) {
+        for (size_t j = i0; j < i; ++j) {
+          double tmp = a[i * n + j];
+          a[i * n + j] = a[j * n + i];
+          a[j * n + i] = tmp;
+        }
+      }
+      continue;
+    }
+
+    // X is the mb x nb tile below the diagonal, Y its nb x mb mirror
+    double buf[TRANSPOSE_TILE * TRANSPOSE_TILE];
+    double* x = a + i0 * n + j0;
+    double* y = a + j0 * n + i0;
+
+    mat_transpose_block(kern, mb, nb, x, n, buf, TRANSPOSE_TILE);
+    mat_transpose_block(kern, nb, mb, y, n, x, n);
+    for (size_t r = 0; r < nb; ++r) {
+      memcpy(y + r * n, buf + r * TRANSPOSE_TILE, mb * sizeof(double));
+    }
+  }
+}
+
+/* internal helper: in-place transpose of a rows x cols row-major matrix by
+ * following the cycles of the permutation p -> p * rows mod (N - 1), with one
+ * bit per element recording what has been moved */
+static util_error_t mat_transpose_cycles(double* a, size_t rows, size_t cols) {
+  const size_t elements = rows * cols;
+  if (elements < 3) {
+    return ERR_OK;
+  }
+
+  unsigned char* moved = (unsigned char*)calloc((elements + 7) / 8, 1);
+  if (moved == NULL) {
+    return ERR_ALLOC;
+  }
+
+  // The first and last elements never move
+  const uint64_t modulus = (uint64_t)elements - 1;
+  for (size_t start = 1; start < elements - 1; ++start) {
+    if (moved[start / 8] & (1u << (start % 8))) {
+      continue;
+    }
+
+    double carry = a[start];
+    size_t p = start;
+    do {
+      const size_t dest = (size_t)(((uint64_t)p * rows) % modulus);
+      double tmp = a[dest];
+      a[dest] = carry;
+      carry = tmp;
+      moved[dest / 8] |= (unsigned char)(1u << (dest % 8));
+      p = dest;
+    } while (p != start);
+  }
+
+  free(moved);
+  return ERR_OK;
+}
+
+util_error_t mat_transpose_rc(const mat_t* restrict a, mat_t* restrict out) {
+  if (a == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->data == NULL || out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->rows != out->cols || a->cols != out->rows) {
+    return ERR_DIM;
+  }
+
+  const size_t rows = a->rows;
+  const size_t cols = a->cols;
+
+  const double* restrict a_data = a->data;
+  double* restrict out_data = out->data;
+
+  // Tiles keep both the reads and the strided writes inside a few pages
+  const simd_kernels_t* kern = simd_kernels();
+  const size_t tile_rows = (rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+  const size_t tile_cols = (cols + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+  const size_t count = tile_rows * tile_cols;
+
+  #pragma omp parallel for schedule(static) \
+      if (rows * cols >= par_threshold(PAR_STREAM))
+  for (size_t t = 0; t < count; ++t) {
+    const size_t i0 = (t / tile_cols) * TRANSPOSE_TILE;
+    const size_t j0 = (t % tile_cols) * TRANSPOSE_TILE;
+    const size_t mb = (rows - i0 < TRANSPOSE_TILE) ? rows - i0 : TRANSPOSE_TILE;
+    const size_t nb = (cols - j0 < TRANSPOSE_TILE) ? cols - j0 : TRANSPOSE_TILE;
+
+    mat_transpose_block(kern, mb, nb, a_data + i0 * cols + j0, cols,
+                        out_data + j0 * rows + i0, rows);
+  }
+
+  return ERR_OK;
+}
+
+util_error_t mat_transpose_inplace_rc(mat_t* m) {
+  if (m == NULL || m->data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (m->rows == m->cols) {
+    mat_transpose_square(m->data, m->rows);
+    return ERR_OK;
+  }
+
+  if (m->rows > 1 && m->cols > 1) {
+    util_error_t rc = mat_transpose_cycles(m->data, m->rows, m->cols);
+    if (rc != ERR_OK) {
+      return rc;
+    }
+  }
+
+  const size_t rows = m->rows;
+  m->rows = m->cols;
+  m->cols = rows;
+
+  return ERR_OK;
+}
+
+util_error_t mat_reshape_rc(mat_t* restrict m, size_t new_rows,
+                            size_t new_cols) {
+  if (m == NULL || m->data == NULL) {
+    return ERR_NULL;
+  }
+
+  size_t old_elements = m->rows * m->cols;
+  size_t new_elements = new_rows * new_cols;
+
+  if (old_elements != new_elements) {
+    return ERR_DIM;
+  }
+
+  m->rows = new_rows;
+  m->cols = new_cols;
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                        Linear Algebra                        */
+/* ============================================================ */
+
+util_error_t mat_det_rc(const mat_t* restrict m, double* restrict out) {
+  if (m == NULL || m->data == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  mat_factor_t* f = NULL;
+
+  util_error_t rc = mat_factor_lu_rc(m, &f);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  rc = mat_factor_det_rc(f, out);
+
+  mat_factor_free_rc(f);
+  return rc;
+}
+
+util_error_t mat_logdet_rc(const mat_t* restrict m, double* restrict sign,
+                           double* restrict out) {
+  if (m == NULL || m->data == NULL || sign == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  mat_factor_t* f = NULL;
+
+  util_error_t rc = mat_factor_lu_rc(m, &f);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  rc = mat_factor_logdet_rc(f, sign, out);
+
+  mat_factor_free_rc(f);
+  return rc;
+}
+
+util_error_t mat_inverse_rc(const mat_t* restrict m, mat_t* restrict out) {
+  if (m == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (m->data == NULL || out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (!mat_same_shape(m, out)) {
+    return ERR_DIM;
+  }
+
+  mat_factor_t* f = NULL;
+
+  util_error_t rc = mat_factor_lu_rc(m, &f);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  rc = mat_factor_inverse_rc(f, out);
+
+  mat_factor_free_rc(f);
+  return rc;
+}
+
+util_error_t mat_solve_rc(const mat_t* restrict a, const vec_t* restrict b,
+                          vec_t* restrict out) {
+  if (a == NULL || b == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->data == NULL || b->data == NULL || out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (b->n != a->rows || out->n != a->cols) {
+    return ERR_DIM;
+  }
+
+  mat_factor_t* f = NULL;
+
+  util_error_t rc = mat_factor_lu_rc(a, &f);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  rc = mat_factor_solve_vec_rc(f, b, out);
+
+  mat_factor_free_rc(f);
+  return rc;
+}
+
+util_error_t mat_cholesky_rc(const mat_t* restrict m, mat_t* restrict out) {
+  if (m == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (m->data == NULL || out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (m->rows != m->cols) {
+    return ERR_DIM;
+  }
+
+  if (!mat_same_shape(m, out)) {
+    return ERR_DIM;
+  }
+
+  const size_t n = m->rows;
+
+  mat_copy_rc(m, out);
+
+  util_error_t rc = decomp_cholesky_rc(out->data, n, n);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    memset(&out->data[i * n + i + 1], 0, (n - i - 1) * sizeof(double));
+  }
+
+  return ERR_OK;
+}
+
+util_error_t mat_solve_spd_rc(const mat_t* restrict a, const vec_t* restrict b,
+                              vec_t* restrict out) {
+  if (a == NULL || b == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->data == NULL || b->data == NULL || out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (b->n != a->rows || out->n != a->cols) {
+    return ERR_DIM;
+  }
+
+  mat_factor_t* f = NULL;
+
+  util_error_t rc = mat_factor_cholesky_rc(a, &f);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  rc = mat_factor_solve_vec_rc(f, b, out);
+
+  mat_factor_free_rc(f);
+  return rc;
+}
+
+util_error_t mat_qr_rc(const mat_t* restrict a, mat_t* restrict q,
+                       mat_t* restrict r) {
+  if (a == NULL || q == NULL || r == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->data == NULL || q->data == NULL || r->data == NULL) {
+    return ERR_NULL;
+  }
+
+  const size_t m = a->rows;
+  const size_t n = a->cols;
+  const size_t k = (m < n) ? m : n;
+
+  if (q->rows != m || q->cols != k || r->rows != k || r->cols != n) {
+    return ERR_DIM;
+  }
+
+  mat_t* qr = NULL;
+  util_error_t rc = mat_alloc_rc(&qr, m, n);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  double* tau = (double*)malloc(k * sizeof(double));
+  if (tau == NULL) {
+    mat_free_rc(qr);
+    return ERR_ALLOC;
+  }
+
+  mat_copy_rc(a, qr);
+
+  rc = decomp_qr_rc(qr->data, m, n, n, tau);
+  if (rc == ERR_OK) {
+    rc = decomp_qr_form_q_rc(m, k, qr->data, n, tau, q->data, k);
+  }
+
+  if (rc == ERR_OK) {
+    for (size_t i = 0; i < k; ++i) {
+      double* r_row = &r->data[i * n];
+      memset(r_row, 0, i * sizeof(double));
+      memcpy(&r_row[i], &qr->data[i * n + i], (n - i) * sizeof(double));
+    }
+  }
+
+  mat_free_rc(qr);
+  free(tau);
+
+  return rc;
+}
+
+util_error_t mat_lstsq_rc(const mat_t* restrict a, const vec_t* restrict b,
+                          vec_t* restrict out) {
+  if (a == NULL || b == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->data == NULL || b->data == NULL || out->data == NULL) {
+    return ERR_NULL;
+  }
+
+  const size_t m = a->rows;
+  const size_t n = a->cols;
+
+  if (m < n || b->n != m || out->n != n) {
+    return ERR_DIM;
+  }
+
+  mat_t* qr = NULL;
+  util_error_t rc = mat_alloc_rc(&qr, m, n);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  double* tau = (double*)malloc(n * sizeof(double));
+  double* x = (double*)malloc(m * sizeof(double));
+  if (tau == NULL || x == NULL) {
+    mat_free_rc(qr);
+    free(tau);
+    free(x);
+    return ERR_ALLOC;
+  }
+
+  mat_copy_rc(a, qr);
+
+  rc = decomp_qr_rc(qr->data, m, n, n, tau);
+
+  if (rc == ERR_OK) {
+    for (size_t i = 0; i < n; ++i) {
+      if (MAT_AT(qr, i, i) == 0.0) {
+        rc = ERR_DIV_ZERO;
+        break;
+      }
+    }
+  }
+
+  if (rc == ERR_OK) {
+    memcpy(x, b->data, m * sizeof(double));
+    decomp_qr_solve_vec(m, n, qr->data, n, tau, x);
+    memcpy(out->data, x, n * sizeof(double));
+  }
+
+  mat_free_rc(qr);
+  free(tau);
+  free(x);
+
+  return rc;
+}
+
+/* internal helper: reduce a copy of a symmetric matrix to tridiagonal form.
+ * On success *work holds the reflectors and *buf the arrays d (n), e (n) and
+ * tau (n), all owned by the caller. */
+static util_error_t mat_tridiag_copy(const mat_t* restrict m,
+                                     mat_t** restrict work,
+                                     double** restrict buf) {
+  const size_t n = m->rows;
+
+  util_error_t rc = mat_alloc_rc(work, n, n);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  *buf = (double*)malloc(3 * n * sizeof(double));
+  if (*buf == NULL) {
+    mat_freep_rc(work);
+    return ERR_ALLOC;
+  }
+
+  mat_copy_rc(m, *work);
+
+  rc = decomp_tridiag_rc((*work)->data, n, n, *buf, *buf + n, *buf + 2 * n);
+  if (rc != ERR_OK) {
+    mat_freep_rc(work);
+    free(*buf);
+    *buf = NULL;
+  }
+
+  return rc;
+}
+
+util_error_t mat_eigh_rc(const mat_t* restrict m, vec_t* restrict values,
+                         mat_t* restrict vectors) {
+  if (m == NULL || values == NULL) {
+    return ERR_NULL;
+  }
+
+  if (m->data == NULL || values->data == NULL ||
+      (vectors != NULL && vectors->data == NULL)) {
+    return ERR_NULL;
+  }
+
+  if (m->rows != m->cols || values->n != m->rows) {
+    return ERR_DIM;
+  }
+
+  if (vectors != NULL && !mat_same_shape(m, vectors)) {
+    return ERR_DIM;
+  }
+
+  const size_t n = m->rows;
+  mat_t* work = NULL;
+  double* buf = NULL;
+
+  util_error_t rc = mat_tridiag_copy(m, &work, &buf);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  double* d = buf;
+  double* e = buf + n;
+  double* tau = buf + 2 * n;
+
+  if (vectors == NULL) {
+    rc = eigen_tridiag_ql_rc(n, d, e, NULL, 0);
+  } else {
+    rc = eigen_tridiag_dc_rc(n, d, e, vectors->data, n);
+    if (rc == ERR_OK && n > 1) {
+      // V = Q * Z; Q acts on rows 1..n-1 only
+      rc = decomp_qr_apply_q_rc(n - 1, n - 1, &work->data[n], n, tau, n,
+                                &vectors->data[n], n);
+    }
+  }
+
+  if (rc == ERR_OK) {
+    memcpy(values->data, d, n * sizeof(double));
+  }
+
+  mat_free_rc(work);
+  free(buf);
+
+  return rc;
+}
+
+util_error_t mat_eigh_topk_rc(const mat_t* restrict m, size_t k,
+                              vec_t* restrict values,
+                              mat_t* restrict vectors) {
+  if (m == NULL || values == NULL) {
+    return ERR_NULL;
+  }
+
+  if (m->data == NULL || values->data == NULL ||
+      (vectors != NULL && vectors->data == NULL)) {
+    return ERR_NULL;
+  }
+
+  if (m->rows != m->cols) {
+    return ERR_DIM;
+  }
+
+  const size_t n = m->rows;
+
+  if (k == 0 || k > n) {
+    return ERR_RANGE;
+  }
+
+  if (values->n != k ||
+      (vectors != NULL && (vectors->rows != n || vectors->cols != k))) {
+    return ERR_DIM;
+  }
+
+  mat_t* work = NULL;
+  double* buf = NULL;
+
+  util_error_t rc = mat_tridiag_copy(m, &work, &buf);
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
+  double* d = buf;
+  double* e = buf + n;
+  double* tau = buf + 2 * n;
+  double* z = (vectors != NULL) ? vectors->data : NULL;
+
+  rc = eigen_tridiag_select_rc(n, d, e, n - k, k, values->data, z, k);
+
+  if (rc == ERR_OK && z != NULL && n > 1) {
+    rc = decomp_qr_apply_q_rc(n - 1, n - 1, &work->data[n], n, tau, k, &z[k],
+                              k);
+  }
+
+  if (rc == ERR_OK) {
+    // Largest first
+    for (size_t i = 0; i < k / 2; ++i) {
+      const size_t j = k - 1 - i;
+      double tmp = values->data[i];
+      values->data[i] = values->data[j];
+      values->data[j] = tmp;
+
+      for (size_t r = 0; z != NULL && r < n; ++r) {
+        double* z_row = &z[r * k];
+        tmp = z_row[i];
+        z_row[i] = z_row[j];
+        z_row[j] = tmp;
+      }
+    }
+  }
+
+  mat_free_rc(work);
+  free(buf);
+
+  return rc;
+}
+
+/* internal helper: orthonormal basis Q (rows x l) of the columns of Y, which
+ * is overwritten by its QR factors */
+static util_error_t mat_orthonormalize(size_t rows, size_t l, double* y,
+                                       double* q, double* tau) {
+  util_error_t rc = decomp_qr_rc(y, rows, l, l, tau);
+  if (rc == ERR_OK) {
+    rc = decomp_qr_form_q_rc(rows, l, y, l, tau, q, l);
+  }
+  return rc;
+}
+
+util_error_t mat_svd_topk_rc(const mat_t* restrict a, size_t k,
+                             size_t power_iters, vec_t* restrict s,
+                             mat_t* restrict u, mat_t* restrict v) {
+  if (a == NULL || s == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->data == NULL || s->data == NULL || (u != NULL && u->data == NULL) ||
+      (v != NULL && v->data == NULL)) {
+    return ERR_NULL;
+  }
+
+  const size_t m = a->rows;
+  const size_t n = a->cols;
+  const size_t mn = (m < n) ? m : n;
+
+  if (k == 0 || k > mn) {
+    return ERR_RANGE;
+  }
+
+  if (s->n != k || (u != NULL && (u->rows != m || u->cols != k)) ||
+      (v != NULL && (v->rows != n || v->cols != k))) {
+    return ERR_DIM;
+  }
+
+  const size_t l = (k + SVD_OVERSAMPLE < mn) ? k + SVD_OVERSAMPLE : mn;
+
+  // y/q: m x l sample and its basis; z/qz: n x l, the same for A^T;
+  // g/ug: l x l projected problem; tau and sv: l
+  const size_t total = 2 * m * l + 2 * n * l + 2 * l * l + 2 * l;
+  double* buf = (double*)malloc(total * sizeof(double));
+  if (buf == NULL) {
+    return ERR_ALLOC;
+  }
+
+  double* y = buf;
+  double* q = y + m * l;
+  double* z = q + m * l;
+  double* qz = z + n * l;
+  double* g = qz + n * l;
+  double* ug = g + l * l;
+  double* tau = ug + l * l;
+  double* sv = tau + l;
+
+  // Random test matrix, reproducible between calls
+  unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+  for (size_t i = 0; i < n * l; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    z[i] = (double)(seed >> 11) / 9007199254740992.0 - 0.5;
+  }
+
+  // Range finder: Q = orth(A * Omega), refined by power iterations
+  // Q = orth(A * orth(A^T * Q)) that sharpen the decay of the spectrum
+  util_error_t rc = gemm_strided_rc(m, l, n, 1.0, a->data, (ptrdiff_t)n, 1, z,
+                                    (ptrdiff_t)l, 1, 0.0, y, (ptrdiff_t)l, 1);
+  if (rc == ERR_OK) {
+    rc = mat_orthonormalize(m, l, y, q, tau);
+  }
+
+  for (size_t it = 0; it < power_iters && rc == ERR_OK; ++it) {
+    rc = gemm_strided_rc(n, l, m, 1.0, a->data, 1, (ptrdiff_t)n, q,
+                         (ptrdiff_t)l, 1, 0.0, z, (ptrdiff_t)l, 1);
+    if (rc == ERR_OK) {
+      rc = mat_orthonormalize(n, l, z, qz, tau);
+    }
+    if (rc == ERR_OK) {
+      rc = gemm_strided_rc(m, l, n, 1.0, a->data, (ptrdiff_t)n, 1, qz,
+                           (ptrdiff_t)l, 1, 0.0, y, (ptrdiff_t)l, 1);
+    }
+    if (rc == ERR_OK) {
+      rc = mat_orthonormalize(m, l, y, q, tau);
+    }
+  }
+
+  // B^T = A^T * Q = Q2 * R; with R = Ug * S * Vg^T, A ~ (Q * Vg) S (Q2 * Ug)^T
+  if (rc == ERR_OK) {
+    rc = gemm_strided_rc(n, l, m, 1.0, a->data, 1, (ptrdiff_t)n, q,
+                         (ptrdiff_t)l, 1, 0.0, z, (ptrdiff_t)l, 1);
+  }
+  if (rc == ERR_OK) {
+    rc = decomp_qr_rc(z, n, l, l, tau);
+  }
+  if (rc == ERR_OK) {
+    for (size_t i = 0; i < l; ++i) {
+      memset(&g[i * l], 0, i * sizeof(double));
+      memcpy(&g[i * l + i], &z[i * l + i], (l - i) * sizeof(double));
+    }
+    rc = decomp_svd_jacobi_rc(l, l, g, l, sv, ug, l);
+  }
+
+  if (rc == ERR_OK && v != NULL) {
+    rc = decomp_qr_form_q_rc(n, l, z, l, tau, qz, l);
+    if (rc == ERR_OK) {
+      rc = gemm_strided_rc(n, k, l, 1.0, qz, (ptrdiff_t)l, 1, ug,
+                           (ptrdiff_t)l, 1, 0.0, v->data, (ptrdiff_t)k, 1);
+    }
+  }
+
+  if (rc == ERR_OK && u != NULL) {
+    // Rows of g hold Vg^T, so Vg is read through swapped strides
+    rc = gemm_strided_rc(m, k, l, 1.0, q, (ptrdiff_t)l, 1, g, 1, (ptrdiff_t)l,
+                         0.0, u->data, (ptrdiff_t)k, 1);
+  }
+
+  if (rc == ERR_OK) {
+    memcpy(s->data, sv, k * sizeof(double));
+  }
+
+  free(buf);
+
+  return rc;
+}
+
+/* ============================================================ */
+/*              Properties, Comparison and Utility              */
+/* ============================================================ */
+
+util_error_t mat_is_square_rc(const mat_t* restrict m, bool* restrict out) {
+  if (m == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  *out = (m->rows == m->cols);
+
+  return ERR_OK;
+}
+
+util_error_t mat_is_equal_rc(const mat_t* restrict a, const mat_t* restrict b,
+                             double epsilon, bool* restrict out) {
+  if (a == NULL || b == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a->data == NULL || b->data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (!mat_same_shape(a, b)) {
+    *out = false;
+    return ERR_OK;
+  }
+
+  const size_t n = a->rows * a->cols;
+  const double* restrict a_data = a->data;
+  const double* restrict b_data = b->data;
+
+  for (size_t i = 0; i < n; ++i) {
+    if (fabs(a_data[i] - b_data[i]) > epsilon) {
+      *out = false;
+      return ERR_OK;
+    }
+  }
+
+  *out = true;
+
+  return ERR_OK;
+}
+
+util_error_t mat_sum_rc(const mat_t* restrict m, double* restrict out) {
+  if (m == NULL || m->data == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  const size_t n = m->rows * m->cols;
+  const double* restrict m_data = m->data;
+  double total_sum = 0.0;
+
+  if (n < par_threshold(PAR_REDUCE)) {
+    for (size_t i = 0; i < n; ++i) {
+      total_sum += m_data[i];
+    }
+    *out = total_sum;
+    return ERR_OK;
+  }
+
+  #pragma omp parallel for reduction(+ : total_sum) schedule(static)
+  for (size_t i = 0; i < n; ++i) {
+    total_sum += m_data[i];
+  }
+
+  *out = total_sum;
+  return ERR_OK;
+}
+
+util_error_t mat_swap_rc(mat_t* restrict a, mat_t* restrict b) {
+  if (a == NULL || b == NULL) {
+    return ERR_NULL;
+  }
+
+  if (a == b) {
+    return ERR_OK;
+  }
+
+  // Inline data cannot leave its header: equal shapes swap contents,
+  // anything else moves the data out first
+  if (mat_is_inline(a) && mat_is_inline(b) && mat_same_shape(a, b)) {
+    const size_t elements = a->rows * a->cols;
+    for (size_t i = 0; i < elements; ++i) {
+      double tmp = a->data[i];
+      a->data[i] = b->data[i];
+      b->data[i] = tmp;
+    }
+    return ERR_OK;
+  }
+
+  util_error_t rc = mat_detach(a);
+  if (rc == ERR_OK) {
+    rc = mat_detach(b);
+  }
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
   size_t temp_rows = a->rows;
   a->rows = b->rows;
   b->rows = temp_rows;
@@ -836,6 +2147,14 @@ util_error_t mat_swap_rc(mat_t* restrict a, mat_t* restrict b) {
   a->data = b->data;
   b->data = temp_data;
 
+  bool temp_owns = a->owns_data;
+  a->owns_data = b->owns_data;
+  b->owns_data = temp_owns;
+
+  const alloc_backend_t* temp_backend = a->backend;
+  a->backend = b->backend;
+  b->backend = temp_backend;
+
   return ERR_OK;
 }
 
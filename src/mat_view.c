@@ -0,0 +1,423 @@
+#include "mat_view.h"
+
+#include "gemm.h"
+#include "parallel.h"
+#include "simd.h"
+
+/* internal helper: a view walked as 'outer' lines of 'inner' elements */
+typedef struct {
+  size_t outer;
+  size_t inner;
+  ptrdiff_t outer_stride;
+  ptrdiff_t inner_stride;
+} mat_view_lines_t;
+
+/* internal helper: choose the traversal of a view so that the inner loop
+ * follows its smaller stride (rows of a row-major window, columns of a
+ * transposed one) */
+static inline int mat_view_transposed(const mat_view_t* v) {
+  const ptrdiff_t rs = v->rs < 0 ? -v->rs : v->rs;
+  const ptrdiff_t cs = v->cs < 0 ? -v->cs : v->cs;
+  return v->rows > 1 && v->cols > 1 && rs < cs;
+}
+
+static inline mat_view_lines_t mat_view_lines(const mat_view_t* v,
+                                              int transposed) {
+  mat_view_lines_t l;
+  if (transposed) {
+    l.outer = v->cols;
+    l.inner = v->rows;
+    l.outer_stride = v->cs;
+    l.inner_stride = v->rs;
+  } else {
+    l.outer = v->rows;
+    l.inner = v->cols;
+    l.outer_stride = v->rs;
+    l.inner_stride = v->cs;
+  }
+  return l;
+}
+
+/* internal helper: validate a view */
+static inline int mat_view_valid(const mat_view_t* v) {
+  return v != NULL && v->data != NULL;
+}
+
+static inline int vec_view_valid(const vec_view_t* v) {
+  return v != NULL && v->data != NULL;
+}
+
+/* ============================================================ */
+/*                        View Creation                         */
+/* ============================================================ */
+
+util_error_t mat_view_rc(mat_t* restrict m, mat_view_t* restrict out) {
+  if (m == NULL || m->data == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  out->rows = m->rows;
+  out->cols = m->cols;
+  out->rs = (ptrdiff_t)m->cols;
+  out->cs = 1;
+  out->data = m->data;
+
+  return ERR_OK;
+}
+
+util_error_t vec_view_rc(vec_t* restrict v, vec_view_t* restrict out) {
+  if (v == NULL || v->data == NULL || out == NULL) {
+    return ERR_NULL;
+  }
+
+  out->n = v->n;
+  out->inc = 1;
+  out->data = v->data;
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_sub_rc(const mat_view_t* v, size_t i0, size_t j0,
+                             size_t rows, size_t cols, mat_view_t* out) {
+  if (!mat_view_valid(v) || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (rows == 0 || cols == 0) {
+    return ERR_RANGE;
+  }
+
+  if (i0 > v->rows || rows > v->rows - i0 || j0 > v->cols ||
+      cols > v->cols - j0) {
+    return ERR_RANGE;
+  }
+
+  double* data = &MAT_VIEW_AT(v, i0, j0);
+  const ptrdiff_t rs = v->rs;
+  const ptrdiff_t cs = v->cs;
+
+  out->rows = rows;
+  out->cols = cols;
+  out->rs = rs;
+  out->cs = cs;
+  out->data = data;
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_transpose_rc(const mat_view_t* v, mat_view_t* out) {
+  if (!mat_view_valid(v) || out == NULL) {
+    return ERR_NULL;
+  }
+
+  const mat_view_t t = {v->cols, v->rows, v->cs, v->rs, v->data};
+  *out = t;
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_row_rc(const mat_view_t* restrict v, size_t row,
+                             vec_view_t* restrict out) {
+  if (!mat_view_valid(v) || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (row >= v->rows) {
+    return ERR_RANGE;
+  }
+
+  out->n = v->cols;
+  out->inc = v->cs;
+  out->data = &MAT_VIEW_AT(v, row, 0);
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_col_rc(const mat_view_t* restrict v, size_t col,
+                             vec_view_t* restrict out) {
+  if (!mat_view_valid(v) || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (col >= v->cols) {
+    return ERR_RANGE;
+  }
+
+  out->n = v->rows;
+  out->inc = v->rs;
+  out->data = &MAT_VIEW_AT(v, 0, col);
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_diag_rc(const mat_view_t* restrict v,
+                              vec_view_t* restrict out) {
+  if (!mat_view_valid(v) || out == NULL) {
+    return ERR_NULL;
+  }
+
+  out->n = (v->rows < v->cols) ? v->rows : v->cols;
+  out->inc = v->rs + v->cs;
+  out->data = v->data;
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                      Matrix View Kernels                     */
+/* ============================================================ */
+
+util_error_t mat_view_copy_rc(const mat_view_t* restrict src,
+                              const mat_view_t* restrict dst) {
+  if (!mat_view_valid(src) || !mat_view_valid(dst)) {
+    return ERR_NULL;
+  }
+
+  if (src->rows != dst->rows || src->cols != dst->cols) {
+    return ERR_DIM;
+  }
+
+  const int tr = mat_view_transposed(dst);
+  const mat_view_lines_t s = mat_view_lines(src, tr);
+  const mat_view_lines_t d = mat_view_lines(dst, tr);
+  const double* s_data = src->data;
+  double* d_data = dst->data;
+
+  #pragma omp parallel for schedule(static) \
+      if (d.outer * d.inner >= par_threshold(PAR_STREAM))
+  for (size_t i = 0; i < d.outer; ++i) {
+    const double* s_line = s_data + (ptrdiff_t)i * s.outer_stride;
+    double* d_line = d_data + (ptrdiff_t)i * d.outer_stride;
+    if (s.inner_stride == 1 && d.inner_stride == 1) {
+      for (size_t j = 0; j < d.inner; ++j) {
+        d_line[j] = s_line[j];
+      }
+    } else {
+      for (size_t j = 0; j < d.inner; ++j) {
+        d_line[(ptrdiff_t)j * d.inner_stride] =
+            s_line[(ptrdiff_t)j * s.inner_stride];
+      }
+    }
+  }
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_fill_rc(const mat_view_t* v, double val) {
+  if (!mat_view_valid(v)) {
+    return ERR_NULL;
+  }
+
+  const mat_view_lines_t d = mat_view_lines(v, mat_view_transposed(v));
+  double* d_data = v->data;
+
+  #pragma omp parallel for schedule(static) \
+      if (d.outer * d.inner >= par_threshold(PAR_STREAM))
+  for (size_t i = 0; i < d.outer; ++i) {
+    double* d_line = d_data + (ptrdiff_t)i * d.outer_stride;
+    for (size_t j = 0; j < d.inner; ++j) {
+      d_line[(ptrdiff_t)j * d.inner_stride] = val;
+    }
+  }
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_scale_rc(const mat_view_t* v, double alpha) {
+  if (!mat_view_valid(v)) {
+    return ERR_NULL;
+  }
+
+  const mat_view_lines_t d = mat_view_lines(v, mat_view_transposed(v));
+  double* d_data = v->data;
+  const simd_kernels_t* kern = simd_kernels();
+
+  #pragma omp parallel for schedule(static) \
+      if (d.outer * d.inner >= par_threshold(PAR_STREAM))
+  for (size_t i = 0; i < d.outer; ++i) {
+    double* d_line = d_data + (ptrdiff_t)i * d.outer_stride;
+    if (d.inner_stride == 1) {
+      kern->scale(d.inner, alpha, d_line, d_line);
+    } else {
+      for (size_t j = 0; j < d.inner; ++j) {
+        d_line[(ptrdiff_t)j * d.inner_stride] *= alpha;
+      }
+    }
+  }
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_axpy_rc(double alpha, const mat_view_t* restrict x,
+                              const mat_view_t* restrict y) {
+  if (!mat_view_valid(x) || !mat_view_valid(y)) {
+    return ERR_NULL;
+  }
+
+  if (x->rows != y->rows || x->cols != y->cols) {
+    return ERR_DIM;
+  }
+
+  const int tr = mat_view_transposed(y);
+  const mat_view_lines_t s = mat_view_lines(x, tr);
+  const mat_view_lines_t d = mat_view_lines(y, tr);
+  const double* s_data = x->data;
+  double* d_data = y->data;
+  const simd_kernels_t* kern = simd_kernels();
+
+  #pragma omp parallel for schedule(static) \
+      if (d.outer * d.inner >= par_threshold(PAR_STREAM))
+  for (size_t i = 0; i < d.outer; ++i) {
+    const double* s_line = s_data + (ptrdiff_t)i * s.outer_stride;
+    double* d_line = d_data + (ptrdiff_t)i * d.outer_stride;
+    if (s.inner_stride == 1 && d.inner_stride == 1) {
+      kern->axpy(d.inner, alpha, s_line, d_line);
+    } else {
+      for (size_t j = 0; j < d.inner; ++j) {
+        d_line[(ptrdiff_t)j * d.inner_stride] +=
+            alpha * s_line[(ptrdiff_t)j * s.inner_stride];
+      }
+    }
+  }
+
+  return ERR_OK;
+}
+
+util_error_t mat_view_gemm_rc(double alpha, const mat_view_t* a,
+                              const mat_view_t* b, double beta,
+                              const mat_view_t* c) {
+  if (!mat_view_valid(a) || !mat_view_valid(b) || !mat_view_valid(c)) {
+    return ERR_NULL;
+  }
+
+  if (a->cols != b->rows || a->rows != c->rows || b->cols != c->cols) {
+    return ERR_DIM;
+  }
+
+  return gemm_strided_rc(c->rows, c->cols, a->cols, alpha, a->data, a->rs,
+                         a->cs, b->data, b->rs, b->cs, beta, c->data, c->rs,
+                         c->cs);
+}
+
+util_error_t mat_view_gemv_rc(double alpha, const mat_view_t* a,
+                              const vec_view_t* x, double beta,
+                              const vec_view_t* y) {
+  if (!mat_view_valid(a) || !vec_view_valid(x) || !vec_view_valid(y)) {
+    return ERR_NULL;
+  }
+
+  if (a->cols != x->n || a->rows != y->n) {
+    return ERR_DIM;
+  }
+
+  const size_t rows = a->rows;
+  const size_t cols = a->cols;
+  const simd_kernels_t* kern = simd_kernels();
+
+  #pragma omp parallel for schedule(static) \
+      if (rows * cols >= par_threshold(PAR_REDUCE))
+  for (size_t i = 0; i < rows; ++i) {
+    const double* a_row = a->data + (ptrdiff_t)i * a->rs;
+    double acc;
+    if (a->cs == 1 && x->inc == 1) {
+      acc = kern->dot(cols, a_row, x->data);
+    } else {
+      acc = 0.0;
+      for (size_t j = 0; j < cols; ++j) {
+        acc += a_row[(ptrdiff_t)j * a->cs] * VEC_VIEW_AT(x, j);
+      }
+    }
+
+    double* yi = &VEC_VIEW_AT(y, i);
+    *yi = (beta == 0.0) ? alpha * acc : alpha * acc + beta * *yi;
+  }
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                      Vector View Kernels                     */
+/* ============================================================ */
+
+util_error_t vec_view_copy_rc(const vec_view_t* restrict src,
+                              const vec_view_t* restrict dst) {
+  if (!vec_view_valid(src) || !vec_view_valid(dst)) {
+    return ERR_NULL;
+  }
+
+  if (src->n != dst->n) {
+    return ERR_DIM;
+  }
+
+  const size_t n = dst->n;
+
+  #pragma omp parallel for schedule(static) if (n >= par_threshold(PAR_STREAM))
+  for (size_t i = 0; i < n; ++i) {
+    VEC_VIEW_AT(dst, i) = VEC_VIEW_AT(src, i);
+  }
+
+  return ERR_OK;
+}
+
+util_error_t vec_view_scale_rc(const vec_view_t* v, double alpha) {
+  if (!vec_view_valid(v)) {
+    return ERR_NULL;
+  }
+
+  if (v->inc == 1) {
+    simd_kernels()->scale(v->n, alpha, v->data, v->data);
+    return ERR_OK;
+  }
+
+  for (size_t i = 0; i < v->n; ++i) {
+    VEC_VIEW_AT(v, i) *= alpha;
+  }
+
+  return ERR_OK;
+}
+
+util_error_t vec_view_axpy_rc(double alpha, const vec_view_t* restrict x,
+                              const vec_view_t* restrict y) {
+  if (!vec_view_valid(x) || !vec_view_valid(y)) {
+    return ERR_NULL;
+  }
+
+  if (x->n != y->n) {
+    return ERR_DIM;
+  }
+
+  if (x->inc == 1 && y->inc == 1) {
+    simd_kernels()->axpy(y->n, alpha, x->data, y->data);
+    return ERR_OK;
+  }
+
+  for (size_t i = 0; i < y->n; ++i) {
+    VEC_VIEW_AT(y, i) += alpha * VEC_VIEW_AT(x, i);
+  }
+
+  return ERR_OK;
+}
+
+util_error_t vec_view_dot_rc(const vec_view_t* x, const vec_view_t* y,
+                             double* out) {
+  if (!vec_view_valid(x) || !vec_view_valid(y) || out == NULL) {
+    return ERR_NULL;
+  }
+
+  if (x->n != y->n) {
+    return ERR_DIM;
+  }
+
+  if (x->inc == 1 && y->inc == 1) {
+    *out = simd_kernels()->dot(x->n, x->data, y->data);
+    return ERR_OK;
+  }
+
+  double acc = 0.0;
+  for (size_t i = 0; i < x->n; ++i) {
+    acc += VEC_VIEW_AT(x, i) * VEC_VIEW_AT(y, i);
+  }
+  *out = acc;
+
+  return ERR_OK;
+}
@@ -0,0 +1,240 @@
+#include "parallel.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "config.h"
+#include "linalg_ctx.h"
+#include "simd.h"
+
+// Calibration sizes (elements): doubling from two SIMD chunks, below which the
+// kernels have a single loop iteration anyway, up to the largest probe
+#define PAR_CALIBRATE_MIN (2 * SIMD_CHUNK)
+#define PAR_CALIBRATE_MAX (1UL << 20)
+#define PAR_CALIBRATE_REPS 5
+
+static size_t par_thresholds[PAR_KERNEL_COUNT] = {PAR_STREAM_MIN,
+                                                  PAR_REDUCE_MIN};
+
+static const char* const par_names[PAR_KERNEL_COUNT] = {"stream", "reduce"};
+
+/* ============================================================ */
+/*                          Thresholds                          */
+/* ============================================================ */
+
+size_t par_threshold(par_kernel_t kind) {
+  if ((unsigned)kind >= PAR_KERNEL_COUNT) {
+    return SIZE_MAX;
+  }
+
+  size_t elements;
+  if (linalg_ctx_threshold(kind, &elements)) {
+    return elements;
+  }
+
+  return par_thresholds[kind];
+}
+
+util_error_t par_set_threshold_rc(par_kernel_t kind, size_t elements) {
+  if ((unsigned)kind >= PAR_KERNEL_COUNT) {
+    return ERR_INVALID_ARG;
+  }
+
+  par_thresholds[kind] = elements;
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                         Calibration                          */
+/* ============================================================ */
+
+#ifdef _OPENMP
+/* internal helper: best time of the 'kind' probe over n elements, run exactly
+ * as the kernels run it: one SIMD call on the calling thread below the cutoff,
+ * or the chunked loop split across the team above it */
+static double par_probe(par_kernel_t kind, size_t n, const double* a,
+                        const double* b, double* out, int parallel) {
+  const simd_kernels_t* kern = simd_kernels();
+  double best = HUGE_VAL;
+
+  for (int rep = 0; rep < PAR_CALIBRATE_REPS; ++rep) {
+    const double start = omp_get_wtime();
+
+    if (!parallel) {
+      if (kind == PAR_STREAM) {
+        kern->add(n, a, b, out);
+      } else {
+        out[0] = kern->dot(n, a, b);
+      }
+    } else if (kind == PAR_STREAM) {
+      #pragma omp parallel for schedule(static)
+      for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+        const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+        kern->add(len, a + i, b + i, out + i);
+      }
+    } else {
+      double sum = 0.0;
+      #pragma omp parallel for reduction(+ : sum) schedule(static)
+      for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+        const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+        sum += kern->dot(len, a + i, b + i);
+      }
+      out[0] = sum;
+    }
+
+    const double elapsed = omp_get_wtime() - start;
+    best = (elapsed < best) ? elapsed : best;
+  }
+
+  return best;
+}
+
+/* internal helper: smallest probe size from which the parallel loop of 'kind'
+ * beats the serial one at every larger size, or SIZE_MAX */
+static size_t par_measure(par_kernel_t kind, const double* a, const double* b,
+                          double* out) {
+  size_t threshold = SIZE_MAX;
+  for (size_t n = PAR_CALIBRATE_MAX; n >= PAR_CALIBRATE_MIN; n /= 2) {
+    if (par_probe(kind, n, a, b, out, 1) >= par_probe(kind, n, a, b, out, 0)) {
+      break;
+    }
+    threshold = n;
+  }
+  return threshold;
+}
+#endif
+
+util_error_t par_calibrate_rc(void) {
+#ifdef _OPENMP
+  size_t measured[PAR_KERNEL_COUNT];
+
+  if (omp_get_max_threads() < 2) {
+    for (int k = 0; k < PAR_KERNEL_COUNT; ++k) {
+      measured[k] = SIZE_MAX;
+    }
+  } else {
+    const size_t bytes = PAR_CALIBRATE_MAX * sizeof(double);
+    double* a = (double*)aligned_alloc(ALIGNMENT, bytes);
+    double* b = (double*)aligned_alloc(ALIGNMENT, bytes);
+    double* out = (double*)aligned_alloc(ALIGNMENT, bytes);
+    if (a == NULL || b == NULL || out == NULL) {
+      free(a);
+      free(b);
+      free(out);
+      return ERR_ALLOC;
+    }
+
+    for (size_t i = 0; i < PAR_CALIBRATE_MAX; ++i) {
+      a[i] = 1.0;
+      b[i] = 0.5;
+    }
+
+    // Start the thread team before anything is timed
+    par_probe(PAR_STREAM, PAR_CALIBRATE_MAX, a, b, out, 1);
+
+    for (int k = 0; k < PAR_KERNEL_COUNT; ++k) {
+      measured[k] = par_measure((par_kernel_t)k, a, b, out);
+    }
+
+    free(a);
+    free(b);
+    free(out);
+  }
+
+  memcpy(par_thresholds, measured, sizeof(par_thresholds));
+#endif
+
+  return ERR_OK;
+}
+
+util_error_t par_load_rc(const char* path) {
+  if (path == NULL) {
+    return ERR_NULL;
+  }
+
+  FILE* f = fopen(path, "r");
+  if (f == NULL) {
+    return ERR_IO;
+  }
+
+  size_t loaded[PAR_KERNEL_COUNT];
+  memcpy(loaded, par_thresholds, sizeof(loaded));
+
+  util_error_t rc = ERR_OK;
+  char line[128];
+  while (rc == ERR_OK && fgets(line, sizeof(line), f) != NULL) {
+    char name[32];
+    size_t elements;
+    char extra;
+
+    const char* p = line + strspn(line, " \t\r\n");
+    if (*p == '\0' || *p == '#') {
+      continue;
+    }
+
+    if (sscanf(p, "%31s %zu %c", name, &elements, &extra) != 2) {
+      rc = ERR_INVALID_ARG;
+      break;
+    }
+
+    rc = ERR_INVALID_ARG;
+    for (int k = 0; k < PAR_KERNEL_COUNT; ++k) {
+      if (strcmp(name, par_names[k]) == 0) {
+        loaded[k] = elements;
+        rc = ERR_OK;
+      }
+    }
+  }
+
+  if (rc == ERR_OK && ferror(f)) {
+    rc = ERR_IO;
+  }
+  fclose(f);
+
+  if (rc == ERR_OK) {
+    memcpy(par_thresholds, loaded, sizeof(par_thresholds));
+  }
+
+  return rc;
+}
+
+util_error_t par_save_rc(const char* path) {
+  if (path == NULL) {
+    return ERR_NULL;
+  }
+
+  FILE* f = fopen(path, "w");
+  if (f == NULL) {
+    return ERR_IO;
+  }
+
+  int failed = fputs("# parallel thresholds (elements)\n", f) < 0;
+  for (int k = 0; k < PAR_KERNEL_COUNT; ++k) {
+    failed |= fprintf(f, "%s %zu\n", par_names[k], par_thresholds[k]) < 0;
+  }
+  failed |= fclose(f) != 0;
+
+  return failed ? ERR_IO : ERR_OK;
+}
+
+__attribute__((constructor)) static void par_init(void) {
+  const char* tuning = getenv("LINALG_PAR_TUNING");
+  if (tuning == NULL || *tuning == '\0') {
+    return;
+  }
+
+  // A missing or malformed file leaves the built-in defaults in place
+  if (strcmp(tuning, "calibrate") == 0) {
+    par_calibrate_rc();
+  } else {
+    par_load_rc(tuning);
+  }
+}
@@ -0,0 +1,145 @@
+#include "pool.h"
+
+#include <stdlib.h>
+
+#include "alloc.h"
+#include "config.h"
+
+typedef struct {
+  void* ptr;
+  size_t size_class;  // aligned size, the bucket key
+  size_t usable;      // bytes known to be usable (<= size_class)
+  const alloc_backend_t* backend;  // allocated the buffer; frees it too
+} pool_entry_t;
+
+typedef struct {
+  bool enabled;
+  size_t max_bytes;
+  pool_entry_t entries[POOL_MAX_BUFFERS];  // oldest first
+  pool_stats_t stats;
+} pool_cache_t;
+
+static _Thread_local pool_cache_t pool_tls;
+
+/* internal helper: size class of a request, as get_aligned_size assigns it */
+static inline size_t pool_class(size_t bytes) {
+  return (bytes + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+}
+
+/* internal helper: return a cached buffer to its backend */
+static void pool_entry_free(const pool_entry_t* e) {
+  e->backend->free(e->backend->ctx, e->ptr, e->size_class);
+}
+
+/* internal helper: drop entry i, keeping the age order of the rest */
+static void pool_remove(pool_cache_t* c, size_t i) {
+  c->stats.cached_bytes -= c->entries[i].size_class;
+  for (size_t j = i + 1; j < c->stats.cached_buffers; ++j) {
+    c->entries[j - 1] = c->entries[j];
+  }
+  --c->stats.cached_buffers;
+}
+
+/* internal helper: free the oldest buffers until 'bytes' more fit */
+static void pool_make_room(pool_cache_t* c, size_t bytes) {
+  while (c->stats.cached_buffers > 0 &&
+         (c->stats.cached_buffers == POOL_MAX_BUFFERS ||
+          c->stats.cached_bytes + bytes > c->max_bytes)) {
+    pool_entry_free(&c->entries[0]);
+    pool_remove(c, 0);
+    ++c->stats.evictions;
+  }
+}
+
+/* ============================================================ */
+/*                        Configuration                         */
+/* ============================================================ */
+
+util_error_t pool_enable_rc(size_t max_bytes) {
+  if (max_bytes == 0) {
+    return ERR_RANGE;
+  }
+
+  pool_cache_t* c = &pool_tls;
+  c->enabled = true;
+  c->max_bytes = max_bytes;
+  pool_make_room(c, 0);
+
+  return ERR_OK;
+}
+
+void pool_disable_rc(void) {
+  pool_trim_rc();
+  pool_tls.enabled = false;
+}
+
+void pool_trim_rc(void) {
+  pool_cache_t* c = &pool_tls;
+  for (size_t i = 0; i < c->stats.cached_buffers; ++i) {
+    pool_entry_free(&c->entries[i]);
+  }
+  c->stats.cached_buffers = 0;
+  c->stats.cached_bytes = 0;
+}
+
+util_error_t pool_stats_rc(pool_stats_t* out) {
+  if (out == NULL) {
+    return ERR_NULL;
+  }
+
+  *out = pool_tls.stats;
+
+  return ERR_OK;
+}
+
+/* ============================================================ */
+/*                   Allocation Hooks (internal)                */
+/* ============================================================ */
+
+void* pool_acquire(size_t bytes, const alloc_backend_t* backend) {
+  pool_cache_t* c = &pool_tls;
+  if (!c->enabled) {
+    return NULL;
+  }
+
+  const size_t size_class = pool_class(bytes);
+
+  // Most recently released first: its pages are the likeliest to be cached
+  for (size_t i = c->stats.cached_buffers; i-- > 0;) {
+    const pool_entry_t* e = &c->entries[i];
+    if (e->size_class == size_class && e->usable >= bytes &&
+        e->backend == backend) {
+      void* p = e->ptr;
+      pool_remove(c, i);
+      ++c->stats.hits;
+      return p;
+    }
+  }
+
+  ++c->stats.misses;
+  return NULL;
+}
+
+bool pool_release(void* p, size_t bytes, const alloc_backend_t* backend) {
+  pool_cache_t* c = &pool_tls;
+  if (!c->enabled || p == NULL) {
+    return false;
+  }
+
+  const size_t size_class = pool_class(bytes);
+  if (size_class > c->max_bytes) {
+    return false;
+  }
+
+  pool_make_room(c, size_class);
+
+  pool_entry_t* e = &c->entries[c->stats.cached_buffers++];
+  e->ptr = p;
+  e->size_class = size_class;
+  e->usable = bytes;
+  e->backend = backend;
+  c->stats.cached_bytes += size_class;
+  ++c->stats.releases;
+
+  return true;
+}
@@ -0,0 +1,698 @@
+#include "simd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+/* ============================================================ */
+/*                        Scalar Kernels                        */
+/* ============================================================ */
+
+static void axpy_scalar(size_t n, double a, const double* x, double* y) {
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i) {
+    y[i] = a * x[i] + y[i];
+  }
+}
+
+static double dot_scalar(size_t n, const double* x, const double* y) {
+  double sum = 0.0;
+  #pragma omp simd reduction(+ : sum)
+  for (size_t i = 0; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+static void dot4_scalar(size_t n, const double* a, const double* const* x,
+                        double* out) {
+  const double* x0 = x[0];
+  const double* x1 = x[1];
+  const double* x2 = x[2];
+  const double* x3 = x[3];
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  #pragma omp simd reduction(+ : s0, s1, s2, s3)
+  for (size_t i = 0; i < n; ++i) {
+    const double ai = a[i];
+    s0 += ai * x0[i];
+    s1 += ai * x1[i];
+    s2 += ai * x2[i];
+    s3 += ai * x3[i];
+  }
+  out[0] = s0;
+  out[1] = s1;
+  out[2] = s2;
+  out[3] = s3;
+}
+
+static void add_scalar(size_t n, const double* a, const double* b,
+                       double* out) {
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = a[i] + b[i];
+  }
+}
+
+static void sub_scalar(size_t n, const double* a, const double* b,
+                       double* out) {
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = a[i] - b[i];
+  }
+}
+
+static void scale_scalar(size_t n, double s, const double* x, double* out) {
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = s * x[i];
+  }
+}
+
+#define SCALAR_MR 4
+#define SCALAR_NR 8
+
+static void gemm_kernel_scalar(size_t kc, const double* a, const double* b,
+                               double* ab) {
+  double acc[SCALAR_MR * SCALAR_NR] = {0.0};
+
+  for (size_t p = 0; p < kc; ++p) {
+    for (size_t i = 0; i < SCALAR_MR; ++i) {
+      const double a_ip = a[i];
+      #pragma omp simd
+      for (size_t j = 0; j < SCALAR_NR; ++j) {
+        acc[i * SCALAR_NR + j] += a_ip * b[j];
+      }
+    }
+    a += SCALAR_MR;
+    b += SCALAR_NR;
+  }
+
+  memcpy(ab, acc, sizeof(acc));
+}
+
+static void transpose_4x4_scalar(const double* a, size_t lda, double* b,
+                                 size_t ldb) {
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      b[j * ldb + i] = a[i * lda + j];
+    }
+  }
+}
+
+static const simd_kernels_t SIMD_SCALAR = {
+    .name = "scalar",
+    .axpy = axpy_scalar,
+    .dot = dot_scalar,
+    .dot4 = dot4_scalar,
+    .add = add_scalar,
+    .sub = sub_scalar,
+    .scale = scale_scalar,
+    .gemm_mr = SCALAR_MR,
+    .gemm_nr = SCALAR_NR,
+    .gemm_kernel = gemm_kernel_scalar,
+    .transpose_4x4 = transpose_4x4_scalar,
+};
+
+#ifdef SIMD_X86
+
+/* ============================================================ */
+/*                         SSE2 Kernels                         */
+/* ============================================================ */
+
+SIMD_TARGET("sse2")
+static void axpy_sse2(size_t n, double a, const double* x, double* y) {
+  const __m128d va = _mm_set1_pd(a);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d vy = _mm_loadu_pd(y + i);
+    vy = _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i)), vy);
+    _mm_storeu_pd(y + i, vy);
+  }
+  for (; i < n; ++i) {
+    y[i] = a * x[i] + y[i];
+  }
+}
+
+SIMD_TARGET("sse2")
+static double dot_sse2(size_t n, const double* x, const double* y) {
+  __m128d acc0 = _mm_setzero_pd();
+  __m128d acc1 = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(x + i),
+                                       _mm_loadu_pd(y + i)));
+    acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(x + i + 2),
+                                       _mm_loadu_pd(y + i + 2)));
+  }
+  acc0 = _mm_add_pd(acc0, acc1);
+  double sum = _mm_cvtsd_f64(_mm_add_sd(acc0, _mm_unpackhi_pd(acc0, acc0)));
+  for (; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+SIMD_TARGET("sse2")
+static void dot4_sse2(size_t n, const double* a, const double* const* x,
+                      double* out) {
+  __m128d acc[4];
+  for (size_t r = 0; r < 4; ++r) {
+    acc[r] = _mm_setzero_pd();
+  }
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m128d va = _mm_loadu_pd(a + i);
+    for (size_t r = 0; r < 4; ++r) {
+      acc[r] = _mm_add_pd(acc[r], _mm_mul_pd(va, _mm_loadu_pd(x[r] + i)));
+    }
+  }
+  for (size_t r = 0; r < 4; ++r) {
+    double sum =
+        _mm_cvtsd_f64(_mm_add_sd(acc[r], _mm_unpackhi_pd(acc[r], acc[r])));
+    for (size_t t = i; t < n; ++t) {
+      sum += a[t] * x[r][t];
+    }
+    out[r] = sum;
+  }
+}
+
+SIMD_TARGET("sse2")
+static void add_sse2(size_t n, const double* a, const double* b,
+                     double* out) {
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(out + i,
+                  _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+  }
+  for (; i < n; ++i) {
+    out[i] = a[i] + b[i];
+  }
+}
+
+SIMD_TARGET("sse2")
+static void sub_sse2(size_t n, const double* a, const double* b,
+                     double* out) {
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(out + i,
+                  _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+  }
+  for (; i < n; ++i) {
+    out[i] = a[i] - b[i];
+  }
+}
+
+SIMD_TARGET("sse2")
+static void scale_sse2(size_t n, double s, const double* x, double* out) {
+  const __m128d vs = _mm_set1_pd(s);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(out + i, _mm_mul_pd(vs, _mm_loadu_pd(x + i)));
+  }
+  for (; i < n; ++i) {
+    out[i] = s * x[i];
+  }
+}
+
+#define SSE2_MR 4
+#define SSE2_NR 4
+
+SIMD_TARGET("sse2")
+static void gemm_kernel_sse2(size_t kc, const double* a, const double* b,
+                             double* ab) {
+  __m128d c[SSE2_MR][2];
+  for (size_t i = 0; i < SSE2_MR; ++i) {
+    c[i][0] = _mm_setzero_pd();
+    c[i][1] = _mm_setzero_pd();
+  }
+
+  for (size_t p = 0; p < kc; ++p) {
+    const __m128d b0 = _mm_loadu_pd(b);
+    const __m128d b1 = _mm_loadu_pd(b + 2);
+    for (size_t i = 0; i < SSE2_MR; ++i) {
+      const __m128d a_ip = _mm_set1_pd(a[i]);
+      c[i][0] = _mm_add_pd(c[i][0], _mm_mul_pd(a_ip, b0));
+      c[i][1] = _mm_add_pd(c[i][1], _mm_mul_pd(a_ip, b1));
+    }
+    a += SSE2_MR;
+    b += SSE2_NR;
+  }
+
+  for (size_t i = 0; i < SSE2_MR; ++i) {
+    _mm_storeu_pd(ab + i * SSE2_NR, c[i][0]);
+    _mm_storeu_pd(ab + i * SSE2_NR + 2, c[i][1]);
+  }
+}
+
+/* Four 2 x 2 blocks, each transposed with an unpack pair; the off-diagonal
+ * blocks also trade places. */
+SIMD_TARGET("sse2")
+static void transpose_4x4_sse2(const double* a, size_t lda, double* b,
+                               size_t ldb) {
+  for (size_t bi = 0; bi < 4; bi += 2) {
+    for (size_t bj = 0; bj < 4; bj += 2) {
+      const __m128d r0 = _mm_loadu_pd(a + bi * lda + bj);
+      const __m128d r1 = _mm_loadu_pd(a + (bi + 1) * lda + bj);
+      _mm_storeu_pd(b + bj * ldb + bi, _mm_unpacklo_pd(r0, r1));
+      _mm_storeu_pd(b + (bj + 1) * ldb + bi, _mm_unpackhi_pd(r0, r1));
+    }
+  }
+}
+
+static const simd_kernels_t SIMD_SSE2 = {
+    .name = "sse2",
+    .axpy = axpy_sse2,
+    .dot = dot_sse2,
+    .dot4 = dot4_sse2,
+    .add = add_sse2,
+    .sub = sub_sse2,
+    .scale = scale_sse2,
+    .gemm_mr = SSE2_MR,
+    .gemm_nr = SSE2_NR,
+    .gemm_kernel = gemm_kernel_sse2,
+    .transpose_4x4 = transpose_4x4_sse2,
+};
+
+/* ============================================================ */
+/*                       AVX2/FMA Kernels                       */
+/* ============================================================ */
+
+SIMD_TARGET("avx2,fma")
+static void axpy_avx2(size_t n, double a, const double* x, double* y) {
+  const __m256d va = _mm256_set1_pd(a);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256d y0 = _mm256_loadu_pd(y + i);
+    __m256d y1 = _mm256_loadu_pd(y + i + 4);
+    y0 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), y0);
+    y1 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i + 4), y1);
+    _mm256_storeu_pd(y + i, y0);
+    _mm256_storeu_pd(y + i + 4, y1);
+  }
+  for (; i < n; ++i) {
+    y[i] = a * x[i] + y[i];
+  }
+}
+
+SIMD_TARGET("avx2,fma")
+static double dot_avx2(size_t n, const double* x, const double* y) {
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  __m256d acc2 = _mm256_setzero_pd();
+  __m256d acc3 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i),
+                           acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4),
+                           _mm256_loadu_pd(y + i + 4), acc1);
+    acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8),
+                           _mm256_loadu_pd(y + i + 8), acc2);
+    acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12),
+                           _mm256_loadu_pd(y + i + 12), acc3);
+  }
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i),
+                           acc0);
+  }
+  acc0 = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+  __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc0),
+                            _mm256_extractf128_pd(acc0, 1));
+  double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+  for (; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+/* Each element of a is loaded once and feeds one FMA per right-hand side; the
+ * four accumulators are reduced together with two horizontal adds. */
+SIMD_TARGET("avx2,fma")
+static void dot4_avx2(size_t n, const double* a, const double* const* x,
+                      double* out) {
+  const double* x0 = x[0];
+  const double* x1 = x[1];
+  const double* x2 = x[2];
+  const double* x3 = x[3];
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+  __m256d s2 = _mm256_setzero_pd();
+  __m256d s3 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    s0 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x0 + i), s0);
+    s1 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x1 + i), s1);
+    s2 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x2 + i), s2);
+    s3 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x3 + i), s3);
+  }
+  const __m256d t0 = _mm256_hadd_pd(s0, s1);  // s0 s1 pairs, low and high
+  const __m256d t1 = _mm256_hadd_pd(s2, s3);  // s2 s3 pairs, low and high
+  __m256d sum = _mm256_add_pd(_mm256_permute2f128_pd(t0, t1, 0x20),
+                              _mm256_permute2f128_pd(t0, t1, 0x31));
+  _mm256_storeu_pd(out, sum);
+  for (; i < n; ++i) {
+    out[0] += a[i] * x0[i];
+    out[1] += a[i] * x1[i];
+    out[2] += a[i] * x2[i];
+    out[3] += a[i] * x3[i];
+  }
+}
+
+SIMD_TARGET("avx2,fma")
+static void add_avx2(size_t n, const double* a, const double* b,
+                     double* out) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i),
+                                            _mm256_loadu_pd(b + i)));
+  }
+  for (; i < n; ++i) {
+    out[i] = a[i] + b[i];
+  }
+}
+
+SIMD_TARGET("avx2,fma")
+static void sub_avx2(size_t n, const double* a, const double* b,
+                     double* out) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i),
+                                            _mm256_loadu_pd(b + i)));
+  }
+  for (; i < n; ++i) {
+    out[i] = a[i] - b[i];
+  }
+}
+
+SIMD_TARGET("avx2,fma")
+static void scale_avx2(size_t n, double s, const double* x, double* out) {
+  const __m256d vs = _mm256_set1_pd(s);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(out + i, _mm256_mul_pd(vs, _mm256_loadu_pd(x + i)));
+  }
+  for (; i < n; ++i) {
+    out[i] = s * x[i];
+  }
+}
+
+#define AVX2_MR 6
+#define AVX2_NR 8
+
+SIMD_TARGET("avx2,fma")
+static void gemm_kernel_avx2(size_t kc, const double* a, const double* b,
+                             double* ab) {
+  __m256d c[AVX2_MR][2];
+  for (size_t i = 0; i < AVX2_MR; ++i) {
+    c[i][0] = _mm256_setzero_pd();
+    c[i][1] = _mm256_setzero_pd();
+  }
+
+  for (size_t p = 0; p < kc; ++p) {
+    const __m256d b0 = _mm256_loadu_pd(b);
+    const __m256d b1 = _mm256_loadu_pd(b + 4);
+    for (size_t i = 0; i < AVX2_MR; ++i) {
+      const __m256d a_ip = _mm256_broadcast_sd(a + i);
+      c[i][0] = _mm256_fmadd_pd(a_ip, b0, c[i][0]);
+      c[i][1] = _mm256_fmadd_pd(a_ip, b1, c[i][1]);
+    }
+    a += AVX2_MR;
+    b += AVX2_NR;
+  }
+
+  for (size_t i = 0; i < AVX2_MR; ++i) {
+    _mm256_storeu_pd(ab + i * AVX2_NR, c[i][0]);
+    _mm256_storeu_pd(ab + i * AVX2_NR + 4, c[i][1]);
+  }
+}
+
+/* Rows are interleaved pairwise within 128-bit lanes, then the lanes are
+ * recombined: four loads, eight shuffles, four stores. */
+SIMD_TARGET("avx2,fma")
+static void transpose_4x4_avx2(const double* a, size_t lda, double* b,
+                               size_t ldb) {
+  const __m256d r0 = _mm256_loadu_pd(a);
+  const __m256d r1 = _mm256_loadu_pd(a + lda);
+  const __m256d r2 = _mm256_loadu_pd(a + 2 * lda);
+  const __m256d r3 = _mm256_loadu_pd(a + 3 * lda);
+
+  const __m256d t0 = _mm256_unpacklo_pd(r0, r1);  // a00 a10 a02 a12
+  const __m256d t1 = _mm256_unpackhi_pd(r0, r1);  // a01 a11 a03 a13
+  const __m256d t2 = _mm256_unpacklo_pd(r2, r3);  // a20 a30 a22 a32
+  const __m256d t3 = _mm256_unpackhi_pd(r2, r3);  // a21 a31 a23 a33
+
+  _mm256_storeu_pd(b, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(b + ldb, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(b + 2 * ldb, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(b + 3 * ldb, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+static const simd_kernels_t SIMD_AVX2 = {
+    .name = "avx2",
+    .axpy = axpy_avx2,
+    .dot = dot_avx2,
+    .dot4 = dot4_avx2,
+    .add = add_avx2,
+    .sub = sub_avx2,
+    .scale = scale_avx2,
+    .gemm_mr = AVX2_MR,
+    .gemm_nr = AVX2_NR,
+    .gemm_kernel = gemm_kernel_avx2,
+    .transpose_4x4 = transpose_4x4_avx2,
+};
+
+/* ============================================================ */
+/*                       AVX-512 Kernels                        */
+/* ============================================================ */
+
+SIMD_TARGET("avx512f")
+static void axpy_avx512(size_t n, double a, const double* x, double* y) {
+  const __m512d va = _mm512_set1_pd(a);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512d y0 = _mm512_loadu_pd(y + i);
+    __m512d y1 = _mm512_loadu_pd(y + i + 8);
+    y0 = _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), y0);
+    y1 = _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i + 8), y1);
+    _mm512_storeu_pd(y + i, y0);
+    _mm512_storeu_pd(y + i + 8, y1);
+  }
+  for (; i + 8 <= n; i += 8) {
+    __m512d y0 = _mm512_loadu_pd(y + i);
+    y0 = _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), y0);
+    _mm512_storeu_pd(y + i, y0);
+  }
+  if (i < n) {
+    const __mmask8 tail = (__mmask8)((1u << (n - i)) - 1u);
+    __m512d y0 = _mm512_maskz_loadu_pd(tail, y + i);
+    y0 = _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(tail, x + i), y0);
+    _mm512_mask_storeu_pd(y + i, tail, y0);
+  }
+}
+
+SIMD_TARGET("avx512f")
+static double dot_avx512(size_t n, const double* x, const double* y) {
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  __m512d acc2 = _mm512_setzero_pd();
+  __m512d acc3 = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i),
+                           acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8),
+                           _mm512_loadu_pd(y + i + 8), acc1);
+    acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16),
+                           _mm512_loadu_pd(y + i + 16), acc2);
+    acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24),
+                           _mm512_loadu_pd(y + i + 24), acc3);
+  }
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i),
+                           acc0);
+  }
+  if (i < n) {
+    const __mmask8 tail = (__mmask8)((1u << (n - i)) - 1u);
+    acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, x + i),
+                           _mm512_maskz_loadu_pd(tail, y + i), acc1);
+  }
+  acc0 = _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3));
+  return _mm512_reduce_add_pd(acc0);
+}
+
+SIMD_TARGET("avx512f")
+static void dot4_avx512(size_t n, const double* a, const double* const* x,
+                        double* out) {
+  __m512d acc[4];
+  for (size_t r = 0; r < 4; ++r) {
+    acc[r] = _mm512_setzero_pd();
+  }
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m512d va = _mm512_loadu_pd(a + i);
+    for (size_t r = 0; r < 4; ++r) {
+      acc[r] = _mm512_fmadd_pd(va, _mm512_loadu_pd(x[r] + i), acc[r]);
+    }
+  }
+  if (i < n) {
+    const __mmask8 tail = (__mmask8)((1u << (n - i)) - 1u);
+    const __m512d va = _mm512_maskz_loadu_pd(tail, a + i);
+    for (size_t r = 0; r < 4; ++r) {
+      acc[r] = _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(tail, x[r] + i),
+                               acc[r]);
+    }
+  }
+  for (size_t r = 0; r < 4; ++r) {
+    out[r] = _mm512_reduce_add_pd(acc[r]);
+  }
+}
+
+SIMD_TARGET("avx512f")
+static void add_avx512(size_t n, const double* a, const double* b,
+                       double* out) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(a + i),
+                                            _mm512_loadu_pd(b + i)));
+  }
+  if (i < n) {
+    const __mmask8 tail = (__mmask8)((1u << (n - i)) - 1u);
+    _mm512_mask_storeu_pd(out + i, tail,
+                          _mm512_add_pd(_mm512_maskz_loadu_pd(tail, a + i),
+                                        _mm512_maskz_loadu_pd(tail, b + i)));
+  }
+}
+
+SIMD_TARGET("avx512f")
+static void sub_avx512(size_t n, const double* a, const double* b,
+                       double* out) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(a + i),
+                                            _mm512_loadu_pd(b + i)));
+  }
+  if (i < n) {
+    const __mmask8 tail = (__mmask8)((1u << (n - i)) - 1u);
+    _mm512_mask_storeu_pd(out + i, tail,
+                          _mm512_sub_pd(_mm512_maskz_loadu_pd(tail, a + i),
+                                        _mm512_maskz_loadu_pd(tail, b + i)));
+  }
+}
+
+SIMD_TARGET("avx512f")
+static void scale_avx512(size_t n, double s, const double* x, double* out) {
+  const __m512d vs = _mm512_set1_pd(s);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(out + i, _mm512_mul_pd(vs, _mm512_loadu_pd(x + i)));
+  }
+  if (i < n) {
+    const __mmask8 tail = (__mmask8)((1u << (n - i)) - 1u);
+    _mm512_mask_storeu_pd(out + i, tail,
+                          _mm512_mul_pd(vs, _mm512_maskz_loadu_pd(tail, x + i)));
+  }
+}
+
+#define AVX512_MR 8
+#define AVX512_NR 16
+
+SIMD_TARGET("avx512f")
+static void gemm_kernel_avx512(size_t kc, const double* a, const double* b,
+                               double* ab) {
+  __m512d c[AVX512_MR][2];
+  for (size_t i = 0; i < AVX512_MR; ++i) {
+    c[i][0] = _mm512_setzero_pd();
+    c[i][1] = _mm512_setzero_pd();
+  }
+
+  for (size_t p = 0; p < kc; ++p) {
+    const __m512d b0 = _mm512_loadu_pd(b);
+    const __m512d b1 = _mm512_loadu_pd(b + 8);
+    for (size_t i = 0; i < AVX512_MR; ++i) {
+      const __m512d a_ip = _mm512_set1_pd(a[i]);
+      c[i][0] = _mm512_fmadd_pd(a_ip, b0, c[i][0]);
+      c[i][1] = _mm512_fmadd_pd(a_ip, b1, c[i][1]);
+    }
+    a += AVX512_MR;
+    b += AVX512_NR;
+  }
+
+  for (size_t i = 0; i < AVX512_MR; ++i) {
+    _mm512_storeu_pd(ab + i * AVX512_NR, c[i][0]);
+    _mm512_storeu_pd(ab + i * AVX512_NR + 8, c[i][1]);
+  }
+}
+
+static const simd_kernels_t SIMD_AVX512 = {
+    .name = "avx512",
+    .axpy = axpy_avx512,
+    .dot = dot_avx512,
+    .dot4 = dot4_avx512,
+    .add = add_avx512,
+    .sub = sub_avx512,
+    .scale = scale_avx512,
+    .gemm_mr = AVX512_MR,
+    .gemm_nr = AVX512_NR,
+    .gemm_kernel = gemm_kernel_avx512,
+    // A transpose only moves data; 4 x 4 AVX2 tiles already saturate it
+    .transpose_4x4 = transpose_4x4_avx2,
+};
+
+#endif  // SIMD_X86
+
+/* ============================================================ */
+/*                       Runtime Dispatch                       */
+/* ============================================================ */
+
+static const simd_kernels_t* simd_active = NULL;
+
+static const simd_kernels_t* simd_select(void) {
+  // Only the documented level names cap the selection; any other value is
+  // ignored as if the variable were unset
+  const char* cap = getenv("LINALG_SIMD");
+  if (cap != NULL && strcmp(cap, "scalar") != 0 && strcmp(cap, "sse2") != 0 &&
+      strcmp(cap, "avx2") != 0 && strcmp(cap, "avx512") != 0) {
+    cap = NULL;
+  }
+
+  if (cap != NULL && strcmp(cap, "scalar") == 0) {
+    return &SIMD_SCALAR;
+  }
+
+#ifdef SIMD_X86
+  __builtin_cpu_init();
+
+  const int allow_avx512 = (cap == NULL || strcmp(cap, "avx512") == 0);
+  const int allow_avx2 = allow_avx512 || strcmp(cap, "avx2") == 0;
+
+  if (allow_avx512 && __builtin_cpu_supports("avx512f")) {
+    return &SIMD_AVX512;
+  }
+  if (allow_avx2 && __builtin_cpu_supports("avx2") &&
+      __builtin_cpu_supports("fma")) {
+    return &SIMD_AVX2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return &SIMD_SSE2;
+  }
+#endif
+
+  return &SIMD_SCALAR;
+}
+
+__attribute__((constructor)) static void simd_init(void) {
+  simd_active = simd_select();
+}
+
+const simd_kernels_t* simd_kernels(void) {
+  if (simd_active == NULL) {
+    simd_active = simd_select();
+  }
+  return simd_active;
+}
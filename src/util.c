@@ -8,7 +8,10 @@ static const char* const ERROR_MESSAGES[] = {
     "Dimension/size mismatch or invalid size",  // ERR_DIM (3)
     "Index or value out of range",              // ERR_RANGE (4)
     "Invalid argument",                         // ERR_INVALID_ARG (5)
-    "Division by zero"                          // ERR_DIV_ZERO (6)
+    "Division by zero",                         // ERR_DIV_ZERO (6)
+    "Matrix is not positive definite",          // ERR_NOT_POSDEF (7)
+    "Iteration did not converge",               // ERR_NO_CONVERGE (8)
+    "File could not be read or written"         // ERR_IO (9)
 };
 
 #define MAX_ERROR_CODE \
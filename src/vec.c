@@ -34,6 +34,18 @@ vec_t* vec_from_array(const double* src, size_t n) {
   return v;
 }
 
+vec_t* vec_wrap(double* data, size_t n, util_ownership_t own) {
+  vec_t* v = NULL;
+
+  util_error_t rc = vec_wrap_rc(data, &v, n, own);
+
+  if (rc != ERR_OK) {
+    return NULL;
+  }
+
+  return v;
+}
+
 void vec_free(vec_t* v) { vec_free_rc(v); }
 
 void vec_freep(vec_t** vp) { vec_freep_rc(vp); }
@@ -6,9 +6,105 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "alloc.h"
+#include "arena.h"
 #include "config.h"
+#include "parallel.h"
+#include "pool.h"
+#include "simd.h"
 #include "util.h"
 
+// Bytes reserved for the header in front of inline data, keeping it aligned
+#define VEC_HEADER_BYTES \
+  ((sizeof(vec_t) + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1))
+
+/* internal helper: header followed by 'inline_bytes' of data storage in one
+ * block, taken from the current arena if any */
+static vec_t* vec_header_alloc(size_t inline_bytes) {
+  arena_t* arena = arena_current();
+  const size_t bytes = VEC_HEADER_BYTES + inline_bytes;
+  vec_t* v;
+  if (arena != NULL) {
+    v = (vec_t*)arena_alloc(arena, bytes);
+  } else {
+    const size_t rounded =
+        (bytes + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    v = (vec_t*)aligned_alloc(CACHE_LINE_SIZE, rounded);
+  }
+  if (v != NULL) {
+    v->in_arena = (arena != NULL);
+  }
+  return v;
+}
+
+static inline double* vec_inline_data(const vec_t* v) {
+  return (double*)((char*)v + VEC_HEADER_BYTES);
+}
+
+static inline bool vec_is_inline(const vec_t* v) {
+  return v->data == vec_inline_data(v);
+}
+
+/* internal helper: release a header allocated by vec_header_alloc */
+static void vec_header_free(vec_t* v) {
+  if (!v->in_arena) {
+    free(v);
+  }
+}
+
+/* internal helper: separate buffer of n doubles from the installed
+ * allocator backend, recycled through the calling thread's pool when it is
+ * enabled; *backend receives the backend that must release it */
+static double* vec_heap_data(size_t n, const alloc_backend_t** backend) {
+  const alloc_backend_t* b = alloc_backend();
+  double* data = (double*)pool_acquire(n * sizeof(double), b);
+  if (data == NULL) {
+    data = (double*)b->alloc(b->ctx, get_aligned_size(n));
+  }
+  *backend = b;
+  return data;
+}
+
+/* internal helper: release a buffer from vec_heap_data */
+static void vec_heap_free(double* data, size_t n,
+                          const alloc_backend_t* backend) {
+  if (!pool_release(data, n * sizeof(double), backend)) {
+    backend->free(backend->ctx, data, get_aligned_size(n));
+  }
+}
+
+/* internal helper: allocate n elements, from the current arena if any;
+ * *backend is NULL for arena memory, otherwise the backend that must release
+ * the buffer with the vector */
+static double* vec_data_alloc(size_t n, const alloc_backend_t** backend) {
+  arena_t* arena = arena_current();
+  if (arena != NULL) {
+    *backend = NULL;
+    return (double*)arena_alloc(arena, get_aligned_size(n));
+  }
+  return vec_heap_data(n, backend);
+}
+
+/* internal helper: move inline data into a buffer of its own, so that the
+ * data pointer can be handed to another header */
+static util_error_t vec_detach(vec_t* v) {
+  if (!vec_is_inline(v)) {
+    return ERR_OK;
+  }
+
+  const alloc_backend_t* backend;
+  double* data = vec_data_alloc(v->n, &backend);
+  if (data == NULL) {
+    return ERR_ALLOC;
+  }
+
+  memcpy(data, v->data, v->n * sizeof(double));
+  v->data = data;
+  v->owns_data = (backend != NULL);
+  v->backend = backend;
+  return ERR_OK;
+}
+
 /* ============================================================ */
 /*                     Lifecycle Management                     */
 /* ============================================================ */
@@ -22,19 +118,29 @@ util_error_t vec_alloc_rc(vec_t** out, size_t n) {
     return ERR_RANGE;
   }
 
-  vec_t* v = (vec_t*)malloc(sizeof(vec_t));
+  // Header and data share one block unless the data is large
+  const size_t bytes = get_aligned_size(n);
+  const bool co_alloc =
+      (bytes <= INLINE_DATA_MAX_BYTES || arena_current() != NULL);
+
+  vec_t* v = vec_header_alloc(co_alloc ? bytes : 0);
   if (v == NULL) {
     return ERR_ALLOC;
   }
 
   v->n = n;
 
-  size_t aligned_bytes = get_aligned_size(n);
-
-  v->data = (double*)aligned_alloc(ALIGNMENT, aligned_bytes);
-  if (v->data == NULL) {
-    free(v);
-    return ERR_ALLOC;
+  if (co_alloc) {
+    v->data = vec_inline_data(v);
+    v->owns_data = false;
+    v->backend = NULL;
+  } else {
+    v->data = vec_heap_data(n, &v->backend);
+    v->owns_data = true;
+    if (v->data == NULL) {
+      vec_header_free(v);
+      return ERR_ALLOC;
+    }
   }
 
   *out = v;
@@ -60,13 +166,52 @@ util_error_t vec_from_array_rc(const double* data, vec_t** out, size_t n) {
   return ERR_OK;
 }
 
+util_error_t vec_wrap_rc(double* data, vec_t** out, size_t n,
+                         util_ownership_t own) {
+  if (out == NULL || data == NULL) {
+    return ERR_NULL;
+  }
+
+  if (own != OWN_BORROW && own != OWN_ADOPT) {
+    return ERR_INVALID_ARG;
+  }
+
+  if (n == 0 || n > VECTOR_MAX_ELEMENTS) {
+    return ERR_RANGE;
+  }
+
+  // A misaligned buffer is copied so the ALIGNMENT guarantee on 'data' holds
+  if ((uintptr_t)data % ALIGNMENT != 0) {
+    util_error_t rc = vec_from_array_rc(data, out, n);
+    if (rc == ERR_OK && own == OWN_ADOPT) {
+      free(data);
+    }
+    return rc;
+  }
+
+  vec_t* v = vec_header_alloc(0);
+  if (v == NULL) {
+    return ERR_ALLOC;
+  }
+
+  v->n = n;
+  v->data = data;
+  v->owns_data = (own == OWN_ADOPT);
+  v->backend = v->owns_data ? alloc_backend_default() : NULL;
+
+  *out = v;
+  return ERR_OK;
+}
+
 void vec_free_rc(vec_t* v) {
   if (!v) {
     return;
   }
 
-  free(v->data);
-  free(v);
+  if (v->owns_data) {
+    vec_heap_free(v->data, v->n, v->backend);
+  }
+  vec_header_free(v);
 }
 
 void vec_freep_rc(vec_t** vp) {
@@ -74,8 +219,7 @@ void vec_freep_rc(vec_t** vp) {
     return;
   }
 
-  free((*vp)->data);
-  free(*vp);
+  vec_free_rc(*vp);
   *vp = NULL;
 }
 
@@ -94,9 +238,17 @@ util_error_t vec_resize_rc(vec_t** vp, size_t new_n) {
     return ERR_OK;
   }
 
-  size_t new_aligned_bytes = get_aligned_size(new_n);
+  // Inline storage is reused while the new length fits its padding
+  if (vec_is_inline(v) && get_aligned_size(new_n) <= get_aligned_size(v->n)) {
+    if (new_n > v->n) {
+      memset(v->data + v->n, 0, (new_n - v->n) * sizeof(double));
+    }
+    v->n = new_n;
+    return ERR_OK;
+  }
 
-  double* new_data = (double*)aligned_alloc(ALIGNMENT, new_aligned_bytes);
+  const alloc_backend_t* new_backend;
+  double* new_data = vec_data_alloc(new_n, &new_backend);
   if (new_data == NULL) {
     return ERR_ALLOC;
   }
@@ -108,8 +260,12 @@ util_error_t vec_resize_rc(vec_t** vp, size_t new_n) {
     memset(new_data + v->n, 0, (new_n - v->n) * sizeof(double));
   }
 
-  free(v->data);
+  if (v->owns_data) {
+    vec_heap_free(v->data, v->n, v->backend);
+  }
   v->data = new_data;
+  v->owns_data = (new_backend != NULL);
+  v->backend = new_backend;
   v->n = new_n;
   return ERR_OK;
 }
@@ -185,9 +341,17 @@ util_error_t vec_add_rc(const vec_t* restrict a, const vec_t* restrict b,
   const double* restrict b_data = b->data;
   double* restrict out_data = out->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->add(n, a_data, b_data, out_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    out_data[i] = a_data[i] + b_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->add(len, a_data + i, b_data + i, out_data + i);
   }
 
   return ERR_OK;
@@ -209,9 +373,17 @@ util_error_t vec_add_inplace_rc(vec_t* restrict dest,
   double* restrict dest_data = dest->data;
   const double* restrict src_data = src->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->add(n, dest_data, src_data, dest_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    dest_data[i] += src_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->add(len, dest_data + i, src_data + i, dest_data + i);
   }
 
   return ERR_OK;
@@ -234,9 +406,17 @@ util_error_t vec_subtract_rc(const vec_t* restrict a, const vec_t* restrict b,
   const double* restrict b_data = b->data;
   double* restrict out_data = out->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->sub(n, a_data, b_data, out_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    out_data[i] = a_data[i] - b_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->sub(len, a_data + i, b_data + i, out_data + i);
   }
 
   return ERR_OK;
@@ -258,9 +438,17 @@ util_error_t vec_subtract_inplace_rc(vec_t* restrict dest,
   double* restrict dest_data = dest->data;
   const double* restrict src_data = src->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->sub(n, dest_data, src_data, dest_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    dest_data[i] -= src_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->sub(len, dest_data + i, src_data + i, dest_data + i);
   }
 
   return ERR_OK;
@@ -281,6 +469,13 @@ util_error_t vec_negate_rc(const vec_t* restrict v, vec_t* restrict out) {
   const double* restrict v_data = v->data;
   double* restrict out_data = out->data;
 
+  if (n < par_threshold(PAR_STREAM)) {
+    for (size_t i = 0; i < n; ++i) {
+      out_data[i] = -v_data[i];
+    }
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < n; ++i) {
     out_data[i] = -v_data[i];
@@ -309,9 +504,17 @@ util_error_t vec_scale_rc(const vec_t* restrict a, vec_t* restrict out,
   const double* restrict a_data = a->data;
   double* restrict out_data = out->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->scale(n, scalar, a_data, out_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    out_data[i] = a_data[i] * scalar;
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->scale(len, scalar, a_data + i, out_data + i);
   }
 
   return ERR_OK;
@@ -328,9 +531,17 @@ util_error_t vec_scale_inplace_rc(vec_t* restrict v, double scalar) {
   const size_t n = v->n;
   double* restrict v_data = v->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->scale(n, scalar, v_data, v_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    v_data[i] *= scalar;
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->scale(len, scalar, v_data + i, v_data + i);
   }
 
   return ERR_OK;
@@ -351,9 +562,17 @@ util_error_t vec_axpy_rc(double a, const vec_t* restrict x, vec_t* restrict y) {
   const double* restrict x_data = x->data;
   double* restrict y_data = y->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_STREAM)) {
+    kern->axpy(n, a, x_data, y_data);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    y_data[i] = a * x_data[i] + y_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    kern->axpy(len, a, x_data + i, y_data + i);
   }
 
   return ERR_OK;
@@ -376,6 +595,13 @@ util_error_t vec_multiply_rc(const vec_t* restrict a, const vec_t* restrict b,
   const double* restrict b_data = b->data;
   double* restrict out_data = out->data;
 
+  if (n < par_threshold(PAR_STREAM)) {
+    for (size_t i = 0; i < n; ++i) {
+      out_data[i] = a_data[i] * b_data[i];
+    }
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < n; ++i) {
     out_data[i] = a_data[i] * b_data[i];
@@ -425,6 +651,13 @@ util_error_t vec_fill_rc(vec_t* restrict v, double val) {
   const size_t n = v->n;
   double* restrict v_data = v->data;
 
+  if (n < par_threshold(PAR_STREAM)) {
+    for (size_t i = 0; i < n; ++i) {
+      v_data[i] = val;
+    }
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < n; ++i) {
     v_data[i] = val;
@@ -453,11 +686,19 @@ util_error_t vec_dot_rc(const vec_t* restrict a, const vec_t* restrict b,
   const double* restrict a_data = a->data;
   const double* restrict b_data = b->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_REDUCE)) {
+    *out = kern->dot(n, a_data, b_data);
+    return ERR_OK;
+  }
+
   double sum = 0.0;
 
   #pragma omp parallel for reduction(+:sum) schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    sum += a_data[i] * b_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    sum += kern->dot(len, a_data + i, b_data + i);
   }
 
   *out = sum;
@@ -532,11 +773,19 @@ util_error_t vec_len_rc(const vec_t* restrict v, double* restrict out) {
   const size_t n = v->n;
   const double* restrict v_data = v->data;
 
+  const simd_kernels_t* kern = simd_kernels();
+
+  if (n < par_threshold(PAR_REDUCE)) {
+    *out = sqrt(kern->dot(n, v_data, v_data));
+    return ERR_OK;
+  }
+
   double sum = 0.0;
 
   #pragma omp parallel for reduction(+:sum) schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    sum += v_data[i] * v_data[i];
+  for (size_t i = 0; i < n; i += SIMD_CHUNK) {
+    const size_t len = (n - i < SIMD_CHUNK) ? n - i : SIMD_CHUNK;
+    sum += kern->dot(len, v_data + i, v_data + i);
   }
 
   *out = sqrt(sum);
@@ -646,6 +895,13 @@ util_error_t vec_project_rc(const vec_t* restrict a, const vec_t* restrict b,
   const double* restrict b_data = b->data;
   double* restrict out_data = out->data;
 
+  if (n < par_threshold(PAR_STREAM)) {
+    for (size_t i = 0; i < n; ++i) {
+      out_data[i] = scale * b_data[i];
+    }
+    return ERR_OK;
+  }
+
   #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < n; ++i) {
     out_data[i] = scale * b_data[i];
@@ -676,6 +932,14 @@ util_error_t vec_is_equal_rc(const vec_t* restrict a, const vec_t* restrict b,
 
   int diff = 0;
 
+  if (n < par_threshold(PAR_REDUCE)) {
+    for (size_t i = 0; i < n && diff == 0; ++i) {
+      diff = fabs(a_data[i] - b_data[i]) > epsilon;
+    }
+    *out = (diff == 0);
+    return ERR_OK;
+  }
+
   #pragma omp parallel for reduction(|:diff) schedule(static)
   for (size_t i = 0; i < n; ++i) {
     if (fabs(a_data[i] - b_data[i]) > epsilon) {
@@ -690,26 +954,14 @@ util_error_t vec_is_equal_rc(const vec_t* restrict a, const vec_t* restrict b,
 
 util_error_t vec_dist_rc(const vec_t* restrict a, const vec_t* restrict b,
                          double* restrict out) {
-  if (a == NULL || b == NULL || out == NULL) {
-    return ERR_NULL;
-  }
-  if (a->data == NULL || b->data == NULL) {
+  if (out == NULL) {
     return ERR_NULL;
   }
-  if (a->n != b->n) {
-    return ERR_DIM;
-  }
-
-  const size_t n = a->n;
-  const double* restrict a_data = a->data;
-  const double* restrict b_data = b->data;
 
   double sum = 0.0;
-
-  #pragma omp parallel for reduction(+:sum) schedule(static)
-  for (size_t i = 0; i < n; ++i) {
-    double d = b_data[i] - a_data[i];
-    sum += d * d;
+  util_error_t rc = vec_dist_sq_rc(a, b, &sum);
+  if (rc != ERR_OK) {
+    return rc;
   }
 
   *out = sqrt(sum);
@@ -735,6 +987,15 @@ util_error_t vec_dist_sq_rc(const vec_t* restrict a, const vec_t* restrict b,
 
   double sum = 0.0;
 
+  if (n < par_threshold(PAR_REDUCE)) {
+    for (size_t i = 0; i < n; ++i) {
+      double d = b_data[i] - a_data[i];
+      sum += d * d;
+    }
+    *out = sum;
+    return ERR_OK;
+  }
+
   #pragma omp parallel for reduction(+:sum) schedule(static)
   for (size_t i = 0; i < n; ++i) {
     double d = b_data[i] - a_data[i];
@@ -815,6 +1076,14 @@ util_error_t vec_sum_rc(const vec_t* restrict v, double* restrict out) {
 
   double sum = 0.0;
 
+  if (n < par_threshold(PAR_REDUCE)) {
+    for (size_t i = 0; i < n; ++i) {
+      sum += v_data[i];
+    }
+    *out = sum;
+    return ERR_OK;
+  }
+
   #pragma omp parallel for reduction(+:sum) schedule(static)
   for (size_t i = 0; i < n; ++i) {
     sum += v_data[i];
@@ -830,6 +1099,29 @@ util_error_t vec_swap_rc(vec_t* a, vec_t* b) {
     return ERR_NULL;
   }
 
+  if (a == b) {
+    return ERR_OK;
+  }
+
+  // Inline data cannot leave its header: equal lengths swap contents,
+  // anything else moves the data out first
+  if (vec_is_inline(a) && vec_is_inline(b) && a->n == b->n) {
+    for (size_t i = 0; i < a->n; ++i) {
+      double tmp = a->data[i];
+      a->data[i] = b->data[i];
+      b->data[i] = tmp;
+    }
+    return ERR_OK;
+  }
+
+  util_error_t rc = vec_detach(a);
+  if (rc == ERR_OK) {
+    rc = vec_detach(b);
+  }
+  if (rc != ERR_OK) {
+    return rc;
+  }
+
   size_t temp_n = a->n;
   a->n = b->n;
   b->n = temp_n;
@@ -838,6 +1130,14 @@ util_error_t vec_swap_rc(vec_t* a, vec_t* b) {
   a->data = b->data;
   b->data = temp_data;
 
+  bool temp_owns = a->owns_data;
+  a->owns_data = b->owns_data;
+  b->owns_data = temp_owns;
+
+  const alloc_backend_t* temp_backend = a->backend;
+  a->backend = b->backend;
+  b->backend = temp_backend;
+
   return ERR_OK;
 }
 
@@ -9,7 +9,9 @@
 #include <omp.h>
 #endif
 
+#include "alloc.h"
 #include "benchmark_utils.h"
+#include "mat_factor.h"
 #include "mat_rc.h"
 #include "vec_rc.h"
 
@@ -17,6 +19,11 @@
 #define COLS 4000
 #define ITER 1
 
+// Odd shape used to verify the GEMM engine against the reference product
+#define VERIFY_M 257
+#define VERIFY_N 263
+#define VERIFY_K 259
+
 static inline double get_wall_time() {
 #ifdef _OPENMP
   return omp_get_wtime();  // wall-clock time OpenMP
@@ -27,6 +34,29 @@ static inline double get_wall_time() {
 #endif
 }
 
+// Reference product: transpose B and take a dot product per output element
+static double reference_max_error(const mat_t* a, const mat_t* b,
+                                  const mat_t* out) {
+  mat_t* b_t = NULL;
+  mat_alloc_rc(&b_t, b->cols, b->rows);
+  mat_transpose_rc(b, b_t);
+
+  double max_err = 0.0;
+  for (size_t i = 0; i < a->rows; ++i) {
+    for (size_t j = 0; j < b->cols; ++j) {
+      double sum = 0.0;
+      for (size_t k = 0; k < a->cols; ++k) {
+        sum += MAT_AT(a, i, k) * MAT_AT(b_t, j, k);
+      }
+      double err = fabs(sum - MAT_AT(out, i, j));
+      if (err > max_err) max_err = err;
+    }
+  }
+
+  mat_free_rc(b_t);
+  return max_err;
+}
+
 int main() {
 #ifdef _OPENMP
   printf("--- MATRIX HARDCORE PERFORMANCE BENCHMARK (%dx%d) ---\n", ROWS, COLS);
@@ -122,6 +152,76 @@ int main() {
   double multiply_time = get_wall_time() - s;
   printf("[Matrix × Matrix]   Time: %.4f s\n", multiply_time);
 
+  // C = A^T * B^T + 0.5 * C in one pass, no transposed copies
+  s = get_wall_time();
+  for (int i = 0; i < ITER; i++) {
+    mat_gemm_rc(TRANS_T, TRANS_T, 1.0, m1, m2, 0.5, m3);
+    dummy += m3->data[0];
+  }
+  printf("[GEMM A^T B^T acc.] Time: %.4f s\n", get_wall_time() - s);
+
+  // Product + bias + ReLU fused into the GEMM epilogue
+  double* bias = (double*)malloc(COLS * sizeof(double));
+  for (size_t j = 0; j < COLS; j++) bias[j] = 0.01 * (double)j;
+  mat_epilogue_t ep = {.col_bias = bias, .act = MAT_ACT_RELU};
+  s = get_wall_time();
+  for (int i = 0; i < ITER; i++) {
+    mat_gemm_ep_rc(TRANS_NONE, TRANS_NONE, 1.0, m1, m2, 0.0, m3, &ep);
+    dummy += m3->data[0];
+  }
+  printf("[GEMM+Bias+ReLU]    Time: %.4f s\n", get_wall_time() - s);
+  free(bias);
+
+  // Many tiny products (fixed-size small-matrix path)
+  mat_t *s4a = NULL, *s4b = NULL, *s4c = NULL;
+  mat_alloc_rc(&s4a, 4, 4);
+  mat_alloc_rc(&s4b, 4, 4);
+  mat_alloc_rc(&s4c, 4, 4);
+  mat_fill_rc(s4a, 0.25);
+  mat_fill_rc(s4b, 0.5);
+  s = get_wall_time();
+  for (int i = 0; i < 1000000 * ITER; i++) {
+    mat_multiply_rc(s4a, s4b, s4c);
+    s4a->data[0] = s4c->data[0] * 0.5;
+  }
+  dummy += s4c->data[0];
+  printf("[4x4 × 4x4 x1e6]    Time: %.4f s\n", get_wall_time() - s);
+  mat_free_rc(s4a);
+  mat_free_rc(s4b);
+  mat_free_rc(s4c);
+
+  // Strided batch of 10^5 independent 6x6 products
+  const size_t batch = 100000;
+  double* ba = (double*)malloc(batch * 36 * sizeof(double));
+  double* bb = (double*)malloc(batch * 36 * sizeof(double));
+  double* bc = (double*)malloc(batch * 36 * sizeof(double));
+  for (size_t i = 0; i < batch * 36; i++) {
+    ba[i] = sin((double)i);
+    bb[i] = cos((double)i);
+  }
+  s = get_wall_time();
+  for (int i = 0; i < 10 * ITER; i++) {
+    mat_multiply_strided_batched_rc(batch, 6, 6, 6, ba, bb, bc);
+  }
+  dummy += bc[0];
+  printf("[Batched 6x6 x1e5]  Time: %.4f s\n", get_wall_time() - s);
+  free(ba);
+  free(bb);
+  free(bc);
+
+  mat_t *va = NULL, *vb = NULL, *vc = NULL;
+  mat_alloc_rc(&va, VERIFY_M, VERIFY_K);
+  mat_alloc_rc(&vb, VERIFY_K, VERIFY_N);
+  mat_alloc_rc(&vc, VERIFY_M, VERIFY_N);
+  for (size_t i = 0; i < VERIFY_M * VERIFY_K; i++) va->data[i] = sin((double)i);
+  for (size_t i = 0; i < VERIFY_K * VERIFY_N; i++) vb->data[i] = cos((double)i);
+  mat_multiply_rc(va, vb, vc);
+  printf("[Matrix × Matrix]   Max error vs reference: %.3e\n",
+         reference_max_error(va, vb, vc));
+  mat_free_rc(va);
+  mat_free_rc(vb);
+  mat_free_rc(vc);
+
   // 6. Matrix-Vector Multiplication
   vec_t *vx = NULL, *vy = NULL;
   vec_alloc_rc(&vx, COLS);
@@ -136,6 +236,35 @@ int main() {
   double matvec_time = get_wall_time() - s;
   printf("[Matrix × Vector]   Time: %.4f s\n", matvec_time);
 
+  // A^T x without forming A^T (x has ROWS elements, the result COLS)
+  s = get_wall_time();
+  for (int i = 0; i < ITER; i++) {
+    mat_gemv_rc(TRANS_T, 1.0, m1, vy, 0.0, vx);
+    dummy += vx->data[0];
+  }
+  printf("[Matrix^T × Vector] Time: %.4f s\n", get_wall_time() - s);
+
+  // Eight right-hand sides against one pass over m1
+  vec_t* vxs[8] = {NULL};
+  vec_t* vys[8] = {NULL};
+  for (int r = 0; r < 8; r++) {
+    vec_alloc_rc(&vxs[r], COLS);
+    vec_alloc_rc(&vys[r], ROWS);
+    vec_fill_rc(vxs[r], 1.0 + r);
+  }
+
+  s = get_wall_time();
+  for (int i = 0; i < ITER; i++) {
+    mat_vec_multiply_multi_rc(m1, (const vec_t* const*)vxs, vys, 8);
+    dummy += vys[7]->data[0];
+  }
+  printf("[Matrix × 8 Vecs]   Time: %.4f s\n", get_wall_time() - s);
+
+  for (int r = 0; r < 8; r++) {
+    vec_free_rc(vxs[r]);
+    vec_free_rc(vys[r]);
+  }
+
   // 7. Transformations and Reshape
   s = get_wall_time();
   mat_t* mT = NULL;
@@ -170,12 +299,177 @@ int main() {
   }
   printf("[Resize In-place]   Time: %.4f s\n", get_wall_time() - s);
 
+  // 10. Linear Algebra (LU based)
+  mat_t *ma = NULL, *m_inv = NULL;
+  vec_t *v_rhs = NULL, *vsol = NULL;
+  mat_alloc_rc(&ma, ROWS, ROWS);
+  mat_alloc_rc(&m_inv, ROWS, ROWS);
+  vec_alloc_rc(&v_rhs, ROWS);
+  vec_alloc_rc(&vsol, ROWS);
+  for (size_t i = 0; i < (size_t)ROWS * ROWS; i++) ma->data[i] = sin((double)i);
+  for (size_t i = 0; i < ROWS; i++) MAT_AT(ma, i, i) += ROWS;
+  vec_fill_rc(v_rhs, 1.0);
+
+  s = get_wall_time();
+  double det_sign, log_det;
+  for (int i = 0; i < ITER; i++) {
+    mat_logdet_rc(ma, &det_sign, &log_det);
+    mat_solve_rc(ma, v_rhs, vsol);
+    mat_inverse_rc(ma, m_inv);
+    dummy += det_sign * log_det + vsol->data[0] + m_inv->data[0];
+  }
+  printf("[LogDet/Solve/Inv]  Time: %.4f s\n", get_wall_time() - s);
+
+  // Factor once, solve many
+  s = get_wall_time();
+  mat_factor_t* f_lu = NULL;
+  mat_factor_lu_rc(ma, &f_lu);
+  for (int i = 0; i < 100 * ITER; i++) {
+    mat_factor_solve_vec_rc(f_lu, v_rhs, vsol);
+    dummy += vsol->data[0];
+  }
+  mat_factor_free_rc(f_lu);
+  printf("[Factor+Solve x100] Time: %.4f s\n", get_wall_time() - s);
+
+  // Cholesky (ma's lower triangle is symmetric positive definite)
+  s = get_wall_time();
+  for (int i = 0; i < ITER; i++) {
+    mat_cholesky_rc(ma, m_inv);
+    mat_solve_spd_rc(ma, v_rhs, vsol);
+    dummy += m_inv->data[0] + vsol->data[0];
+  }
+  printf("[Cholesky/Solve]    Time: %.4f s\n", get_wall_time() - s);
+
+  // 11. Least Squares (QR based)
+  mat_t* m_tall = NULL;
+  vec_t *v_obs = NULL, *v_coef = NULL;
+  mat_alloc_rc(&m_tall, ROWS, COLS / 8);
+  vec_alloc_rc(&v_obs, ROWS);
+  vec_alloc_rc(&v_coef, COLS / 8);
+  for (size_t i = 0; i < (size_t)ROWS * (COLS / 8); i++) {
+    m_tall->data[i] = sin((double)i * (double)i * 1e-3);
+  }
+  for (size_t i = 0; i < ROWS; i++) v_obs->data[i] = cos((double)i);
+
+  s = get_wall_time();
+  for (int i = 0; i < ITER; i++) {
+    mat_lstsq_rc(m_tall, v_obs, v_coef);
+    dummy += v_coef->data[0];
+  }
+  printf("[Least Squares QR]  Time: %.4f s\n", get_wall_time() - s);
+
+  // 12. Symmetric Eigensolver (the reduction is memory bound, so a smaller
+  // matrix keeps this section in proportion with the others)
+  const size_t eig_n = ROWS / 4;
+  mat_t *m_sym = NULL, *m_evec = NULL;
+  vec_t* v_eval = NULL;
+  mat_alloc_rc(&m_sym, eig_n, eig_n);
+  mat_alloc_rc(&m_evec, eig_n, eig_n);
+  vec_alloc_rc(&v_eval, eig_n);
+  for (size_t i = 0; i < eig_n; i++) {
+    for (size_t j = 0; j <= i; j++) {
+      MAT_AT(m_sym, i, j) = MAT_AT(m_sym, j, i) = sin((double)(i * j + i));
+    }
+  }
+
+  s = get_wall_time();
+  for (int i = 0; i < ITER; i++) {
+    mat_eigh_rc(m_sym, v_eval, m_evec);
+    dummy += v_eval->data[eig_n - 1] + fabs(m_evec->data[0]);
+  }
+  printf("[Eigh Full]         Time: %.4f s\n", get_wall_time() - s);
+
+  s = get_wall_time();
+  mat_resize_rc(&m_evec, eig_n, 8);
+  vec_resize_rc(&v_eval, 8);
+  for (int i = 0; i < ITER; i++) {
+    mat_eigh_topk_rc(m_sym, 8, v_eval, m_evec);
+    dummy += v_eval->data[0] + fabs(m_evec->data[0]);
+  }
+  printf("[Eigh Top-8]        Time: %.4f s\n", get_wall_time() - s);
+
+  // 13. Randomized SVD (rank-50 approximation of the LU test matrix)
+  mat_t *m_svd_u = NULL, *m_svd_v = NULL;
+  vec_t* v_svd_s = NULL;
+  mat_alloc_rc(&m_svd_u, ROWS, 50);
+  mat_alloc_rc(&m_svd_v, ROWS, 50);
+  vec_alloc_rc(&v_svd_s, 50);
+
+  s = get_wall_time();
+  for (int i = 0; i < ITER; i++) {
+    mat_svd_topk_rc(ma, 50, 2, v_svd_s, m_svd_u, m_svd_v);
+    dummy += v_svd_s->data[0] + fabs(m_svd_u->data[0]);
+  }
+  printf("[Randomized SVD]    Time: %.4f s\n", get_wall_time() - s);
+
+  // 14. Allocator Backends (fresh operands, then bandwidth-bound additions)
+  const alloc_backend_t* backends[] = {alloc_backend_default(),
+                                       alloc_backend_hugepage(),
+                                       alloc_backend_numa()};
+  for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); ++b) {
+    alloc_set_backend_rc(backends[b]);
+    s = get_wall_time();
+    mat_t *m_x = NULL, *m_y = NULL, *m_z = NULL;
+    mat_alloc_rc(&m_x, ROWS, COLS);
+    mat_alloc_rc(&m_y, ROWS, COLS);
+    mat_alloc_rc(&m_z, ROWS, COLS);
+    mat_fill_rc(m_x, 1.0);
+    mat_fill_rc(m_y, 2.0);
+    for (int i = 0; i < 10 * ITER; i++) {
+      mat_add_rc(m_x, m_y, m_z);
+    }
+    dummy += m_z->data[0];
+    mat_free_rc(m_x);
+    mat_free_rc(m_y);
+    mat_free_rc(m_z);
+    printf("[Alloc %-8s]    Time: %.4f s\n", backends[b]->name,
+           get_wall_time() - s);
+  }
+  alloc_set_backend_rc(NULL);
+
+  // 15. Pre-packed Operand (many skinny A blocks times the same B)
+  mat_t *m_rows = NULL, *m_rows_out = NULL;
+  mat_packed_t* p_ma = NULL;
+  mat_alloc_rc(&m_rows, 32, ROWS);
+  mat_alloc_rc(&m_rows_out, 32, COLS);
+  mat_fill_rc(m_rows, 0.5);
+
+  s = get_wall_time();
+  for (int i = 0; i < 20 * ITER; i++) {
+    mat_multiply_rc(m_rows, ma, m_rows_out);
+  }
+  printf("[Skinny × B x20]    Time: %.4f s\n", get_wall_time() - s);
+
+  s = get_wall_time();
+  mat_pack_rc(ma, &p_ma);
+  for (int i = 0; i < 20 * ITER; i++) {
+    mat_multiply_packed_rc(m_rows, p_ma, m_rows_out);
+  }
+  dummy += m_rows_out->data[0];
+  printf("[Skinny × Packed]   Time: %.4f s\n", get_wall_time() - s);
+
   // Cleanup
   mat_free_rc(m1);
   mat_freep_rc(&m2);
   mat_free_rc(m3);
   mat_free_rc(m_arr);
   mat_free_rc(mT);
+  mat_free_rc(ma);
+  mat_free_rc(m_inv);
+  vec_free_rc(v_rhs);
+  vec_free_rc(vsol);
+  mat_free_rc(m_tall);
+  vec_free_rc(v_obs);
+  vec_free_rc(v_coef);
+  mat_free_rc(m_sym);
+  mat_free_rc(m_evec);
+  vec_free_rc(v_eval);
+  mat_free_rc(m_svd_u);
+  mat_free_rc(m_svd_v);
+  vec_free_rc(v_svd_s);
+  mat_free_rc(m_rows);
+  mat_free_rc(m_rows_out);
+  mat_packed_free_rc(p_ma);
   vec_free_rc(v_tmp);
   vec_free_rc(vx);
   vec_free_rc(vy);
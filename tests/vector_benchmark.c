@@ -172,7 +172,19 @@ int main() {
   }
   printf("[Logic/Resize/Cr]  Time: %.4f s\n", get_wall_time() - s);
 
-  // 8. freeing up memory
+  // 8. small vectors: per-call latency below the parallel cutoff
+  vec_t* small_out = vec_alloc(3);
+  s = get_wall_time();
+  for (int i = 0; i < ITER * 1000000; i++) {
+    vec_add_rc(c1, c2, small_out);
+    double d = 0.0;
+    vec_dot_rc(c1, small_out, &d);
+    dummy += d;
+  }
+  printf("[Small add+dot]    Time: %.4f s\n", get_wall_time() - s);
+  vec_free(small_out);
+
+  // 9. freeing up memory
   vec_free(v1);
   vec_freep(&v2);
   vec_free(v3);